@@ -21,6 +21,29 @@ enum core_error_t {
 
 #define BD_ADDRESS_LENGTH 6
 
+struct es0_pm_stats {
+	/* ES0 boots done */
+	uint32_t boots;
+	/* Users served by a lingering ES0 without boot */
+	uint32_t boots_avoided;
+	uint32_t shutdowns;
+	/* Duration of the latest and the slowest boot */
+	uint32_t last_boot_us;
+	uint32_t max_boot_us;
+	/* Current linger time after last user release */
+	uint32_t linger_ms;
+	/* Total time ES0 has been running */
+	uint64_t on_time_ms;
+	/* Wake up edges sent, and calls which found ES0 awake */
+	uint32_t wakeups;
+	uint32_t wake_skipped;
+	/* Calls which found another wake up in progress and pulsed as well */
+	uint32_t wake_overlapped;
+	/* Duration of the latest and the slowest wake up */
+	uint32_t last_wake_us;
+	uint32_t max_wake_us;
+};
+
 /**
  * @brief Register a user of a ES0
  * @param baudrate Baudrate used in host side will be passed to LL. All instances must
@@ -38,18 +61,40 @@ int8_t take_es0_into_use(void);
 
 /**
  * @brief De-register a user of a ES0
+ *
+ * With CONFIG_ALIF_PM_ES0_LINGER the shutdown after the last user is delayed
+ * by a linger time learned from recent gaps between release and next use.
+ * A user arriving within the linger time gets ES0 without a new boot.
  * @retval  -1 If no active users
- * @retval  -2 Shutdown of ES0 failed
+ * @retval  -2 Shutdown of ES0 failed, it is shut down and booted again on next use
  */
 int8_t stop_using_es0(void);
 
 /**
- * @brief wakeup ES0 using uart
+ * @brief Get ES0 power statistics
+ * @param p_stats Statistics, on-time includes the ongoing run
+ */
+void es0_pm_stats_get(struct es0_pm_stats *p_stats);
+
+/**
+ * @brief Drop cached ES0 boot parameters
  *
- * ES0 needs to be woken once per boot and should then remain active
- * until ES1 is powered off.
+ * Boot parameters are built once and reused on later ES0 starts, also over
+ * a warm reset when CONFIG_ALIF_PM_NVDS_CACHE_RETAINED is set. After this
+ * call next start rebuilds them, e.g. to pick a new random BD address.
+ */
+void es0_boot_params_invalidate(void);
+
+/**
+ * @brief wakeup ES0 using uart
  *
- * This function can be called as many times during the boot.
+ * Falling edge of RTS is sent after an ES0 boot, and again when the previous
+ * call is older than CONFIG_ALIF_PM_ES0_SLEEP_TIMEOUT_MS while link layer
+ * sleep is enabled. Other calls return immediately, so it can be called
+ * before every transfer. A call made while another one is pulsing returns
+ * only after a full pulse of its own. Data sent right after the pulse is
+ * held by UART hardware flow control until the link layer is ready, the
+ * caller does not wait for it. Safe to call from ISR.
  */
 void wake_es0(const struct device *uart_dev);
 
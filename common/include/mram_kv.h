@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef MRAM_KV_H
+#define MRAM_KV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mram_kv_slot {
+	uint16_t id;
+	uint8_t state;
+	uint32_t off;
+};
+
+/**
+ * Log-structured key/value store on MRAM.
+ *
+ * The area is split in two banks, records are appended to the active one
+ * in 16-byte sectors and compaction copies the live records to the other.
+ * Members are private to mram_kv.c.
+ */
+struct mram_kv {
+	uint8_t *area;
+	uint32_t bank_size;
+	uint8_t bank;
+	uint32_t gen;
+	uint32_t next_gen;
+	/* Append offset and bytes held by live records, in the active bank */
+	uint32_t end;
+	uint32_t live;
+	/* Size of the checkpoint record the bank was mounted or compacted with */
+	uint32_t ckpt_size;
+	uint16_t count;
+	/* Set when the live records did not fit, cleared by a delete */
+	bool compact_blocked;
+	struct k_mutex lock;
+	struct k_work compact_work;
+	struct mram_kv_slot index[CONFIG_ALIF_MRAM_KV_INDEX_SIZE];
+};
+
+/**
+ * @brief Mount the store, formatting the area if it holds no store
+ *
+ * @param kv Store instance.
+ * @param area MRAM area, 16 bytes aligned.
+ * @param size Area size, a multiple of 32 bytes.
+ *
+ * @return 0 if successful.
+ * @return -EINVAL if the area is unusable.
+ * @return -ENOMEM if the store holds more ids than the index fits.
+ */
+int mram_kv_mount(struct mram_kv *kv, uint8_t *area, size_t size);
+
+/**
+ * @brief Read the value of an id
+ *
+ * @return length of the stored value, at most len bytes are copied.
+ * @return -ENOENT if the id has no value.
+ */
+ssize_t mram_kv_read(struct mram_kv *kv, uint16_t id, void *data, size_t len);
+
+/**
+ * @brief Write the value of an id
+ *
+ * The value is committed once this returns, a power loss before that keeps
+ * the previous value. Writing the stored value again is a no-op.
+ *
+ * @return 0 if successful.
+ * @return -ENOSPC if live data would not fit even after compaction.
+ * @return -ENOMEM if the index is full.
+ */
+int mram_kv_write(struct mram_kv *kv, uint16_t id, const void *data, size_t len);
+
+/**
+ * @brief Delete the value of an id, deleting an absent id is a no-op
+ *
+ * @return 0 if successful.
+ * @return -ENOSPC if the delete record would not fit even after compaction.
+ */
+int mram_kv_delete(struct mram_kv *kv, uint16_t id);
+
+/**
+ * @brief Copy the live records to the other bank now
+ *
+ * Also runs in the background from the system work queue once garbage
+ * exceeds CONFIG_ALIF_MRAM_KV_COMPACT_PERCENT of the bank. After -ENOSPC the
+ * background run waits for a delete or a successful compaction.
+ *
+ * @return 0 if successful.
+ * @return -ENOSPC if the live records do not fit one bank.
+ */
+int mram_kv_compact(struct mram_kv *kv);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MRAM_KV_H */
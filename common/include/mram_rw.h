@@ -6,12 +6,16 @@
 #ifndef MRAM_RW_H
 #define MRAM_RW_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 int write_16bytes(uint8_t *, uint8_t *);
 int erase_16bytes(uint8_t *);
+int mram_write(uint8_t *dst, const uint8_t *src, size_t len);
 
 #ifdef __cplusplus
 }
@@ -5,15 +5,60 @@
  */
 #include <string.h>
 #include <zephyr/kernel.h>
+#include <zephyr/cache.h>
+#include <zephyr/sys/crc.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/uart.h>
+#include <zephyr/drivers/entropy.h>
+#include <zephyr/logging/log.h>
 
 #include "es0_power_manager.h"
 #include "se_service.h"
 #include "alif_protocol_const.h"
+LOG_MODULE_REGISTER(es0_pm, CONFIG_SOC_LOG_LEVEL);
 
 static volatile uint8_t es0_user_counter;
-static uint32_t wakeup_count;
+
+/* Wake state of a running ES0, falling RTS edge is needed only when asleep */
+enum es0_wake_state {
+	ES0_WAKE_ASLEEP,
+	ES0_WAKE_WAKING,
+	ES0_WAKE_AWAKE,
+};
+
+static atomic_t es0_wake_state = ATOMIC_INIT(ES0_WAKE_ASLEEP);
+/* Uptime of the last transport call, ES0 may sleep once it gets old */
+static atomic_t es0_activity_ms;
+/* Wake statistics are updated from transport ISRs */
+static struct k_spinlock es0_wake_lock;
+static atomic_t es0_wake_skipped;
+static uint32_t es0_wake_overlapped;
+
+#if defined(CONFIG_ALIF_PM_ES0_LINGER)
+#define ES0_LINGER_MIN_MS CONFIG_ALIF_PM_ES0_LINGER_MIN_MS
+#define ES0_LINGER_MAX_MS CONFIG_ALIF_PM_ES0_LINGER_MAX_MS
+BUILD_ASSERT(ES0_LINGER_MIN_MS <= ES0_LINGER_MAX_MS,
+	     "ES0 minimum linger time must not exceed the maximum");
+#else
+#define ES0_LINGER_MIN_MS 0
+#define ES0_LINGER_MAX_MS 0
+#endif
+
+/* Serializes ES0 start and shutdown between users and the linger work */
+static K_MUTEX_DEFINE(es0_lock);
+/* ES0 is running, possibly without users while lingering */
+static bool es0_running;
+/* Last shutdown failed, ES0 state is unknown until shut down again */
+static bool es0_shutdown_failed;
+static int64_t es0_boot_time;
+static int64_t es0_release_time;
+static uint32_t es0_gap_avg_ms;
+static struct es0_pm_stats es0_stats = {
+	.linger_ms = ES0_LINGER_MIN_MS,
+};
+
+static void es0_linger_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(es0_linger_work, es0_linger_handler);
 
 #define LL_BOOT_PARAMS_MAX_SIZE (512)
 
@@ -75,37 +120,6 @@ static uint32_t wakeup_count;
 #define ES0_PM_ERROR_NO_BAUDRATE          -5
 #define ES0_PM_ERROR_BAUDRATE_MISMATCH    -6
 
-static uint8_t *write_tlv_int(uint8_t *target, uint8_t tag, uint32_t value, uint8_t len)
-{
-	*target++ = tag;
-	*target++ = DEFAULT_TAG_STATUS;
-	*target++ = len;
-	if (len == 1) {
-		memcpy(target, (uint8_t *)&value, len);
-	} else if (len == 2) {
-		memcpy(target, (uint16_t *)&value, len);
-	} else {
-		memcpy(target, &value, len);
-	}
-
-	target += len;
-
-	return target;
-}
-
-static uint8_t *write_tlv_str(uint8_t *target, uint8_t tag, const void *value, uint8_t len)
-{
-	*target++ = tag;
-	*target++ = DEFAULT_TAG_STATUS;
-	*target++ = len;
-
-	memcpy(target, value, len);
-
-	target += len;
-
-	return target;
-}
-
 static const void *bdaddr_reverse(const uint8_t src[6])
 {
 	static uint8_t rev[6];
@@ -117,6 +131,16 @@ static const void *bdaddr_reverse(const uint8_t src[6])
 	return rev;
 }
 
+static void alif_rnd_read(uint8_t *buf, uint16_t len)
+{
+#if defined(CONFIG_ENTROPY_ALIF_SE)
+	/* Small draw is served from the entropy pool without SE round-trip */
+	entropy_get_entropy(DEVICE_DT_GET_ONE(alif_se_entropy), buf, len);
+#else
+	se_service_get_rnd_num(buf, len);
+#endif
+}
+
 static void alif_eui48_read(uint8_t *eui48)
 {
 #ifdef ALIF_IEEE_MA_L_IDENTIFIER
@@ -124,7 +148,7 @@ static void alif_eui48_read(uint8_t *eui48)
 	eui48[1] = (uint8_t)(ALIF_IEEE_MA_L_IDENTIFIER >> 8);
 	eui48[2] = (uint8_t)(ALIF_IEEE_MA_L_IDENTIFIER);
 #else
-	se_service_get_rnd_num(&eui48[0], 3);
+	alif_rnd_read(&eui48[0], 3);
 	eui48[0] |= 0xC0;
 #endif
 	se_system_get_eui_extension(true, &eui48[3]);
@@ -132,196 +156,355 @@ static void alif_eui48_read(uint8_t *eui48)
 		return;
 	}
 	/* Generate Random Local value (ELI) */
-	se_service_get_rnd_num(&eui48[3], 3);
+	alif_rnd_read(&eui48[3], 3);
 }
 
-static uint16_t add_nvds_param_length(uint16_t added_len){
-	return (added_len +3); /* Each write_tlv_x call writes additional 3 bytes */
+/* Link layer UART baudrate, HCI and AHI must agree when both are used */
+#define HCI_BAUDRATE DT_PROP_OR(DT_CHOSEN(zephyr_hci_uart), current_speed, 0)
+#define AHI_BAUDRATE DT_PROP_OR(DT_CHOSEN(zephyr_ahi_uart), current_speed, 0)
+#define ES0_BAUDRATE (HCI_BAUDRATE ? HCI_BAUDRATE : AHI_BAUDRATE)
+
+/* UART input clock can be configured as 16/24/48Mhz */
+#define ES0_UART_CLK_FREQ                                                                         \
+	((ES0_BAUDRATE * 16) <= 16000000   ? 16000000                                              \
+	 : (ES0_BAUDRATE * 16) <= 24000000 ? 24000000                                              \
+					   : 48000000)
+#define ES0_UART_CLK_SEL                                                                          \
+	(ES0_UART_CLK_FREQ == 16000000   ? LL_UART_CLK_SEL_CTRL_16MHZ                              \
+	 : ES0_UART_CLK_FREQ == 24000000 ? LL_UART_CLK_SEL_CTRL_24MHZ                              \
+					 : LL_UART_CLK_SEL_CTRL_48MHZ)
+
+/* Little endian TLV entries of the NVDS boot parameter blob */
+#define NVDS_TLV_HDR(tag, len) (tag), DEFAULT_TAG_STATUS, (len)
+#define NVDS_TLV1(tag, v)      NVDS_TLV_HDR(tag, 1), (uint8_t)(v)
+#define NVDS_TLV2(tag, v)      NVDS_TLV_HDR(tag, 2), (uint8_t)(v), (uint8_t)((v) >> 8)
+#define NVDS_TLV4(tag, v)                                                                         \
+	NVDS_TLV_HDR(tag, 4), (uint8_t)(v), (uint8_t)((v) >> 8), (uint8_t)((v) >> 16),             \
+		(uint8_t)((v) >> 24)
+
+/* BD address value follows the three fixed size entries before it */
+#define NVDS_BD_ADDR_OFFSET                                                                       \
+	(4 + 3 + BOOT_PARAM_LEN_LE_CODED_PHY_500 + 3 + BOOT_PARAM_LEN_DFT_SLAVE_MD + 3 +           \
+	 BOOT_PARAM_LEN_CH_CLASS_REP_INTV + 3)
+
+/* Everything except the device specific BD address is known at build time */
+static const uint8_t nvds_template[] = {
+	'N', 'V', 'D', 'S',
+	NVDS_TLV1(BOOT_PARAM_ID_LE_CODED_PHY_500, CONFIG_ALIF_PM_LE_CODED_PHY_500),
+	NVDS_TLV1(BOOT_PARAM_ID_DFT_SLAVE_MD, CONFIG_ALIF_PM_DFT_SLAVE_MD),
+	NVDS_TLV2(BOOT_PARAM_ID_CH_CLASS_REP_INTV, CONFIG_ALIF_PM_CH_CLASS_REP_INTV),
+	NVDS_TLV_HDR(BOOT_PARAM_ID_BD_ADDRESS, BOOT_PARAM_LEN_BD_ADDRESS), 0, 0, 0, 0, 0, 0,
+	NVDS_TLV1(BOOT_PARAM_ID_ACTIVITY_MOVE_CONFIG, CONFIG_ALIF_PM_ACTIVITY_MOVE_CONFIG),
+	NVDS_TLV1(BOOT_PARAM_ID_SCAN_EXT_ADV, CONFIG_ALIF_PM_SCAN_EXT_ADV),
+	NVDS_TLV1(BOOT_PARAM_ID_RSSI_HIGH_THR, CONFIG_ALIF_PM_RSSI_HIGH_THR),
+	NVDS_TLV1(BOOT_PARAM_ID_RSSI_LOW_THR, CONFIG_ALIF_PM_RSSI_LOW_THR),
+	NVDS_TLV1(BOOT_PARAM_ID_SLEEP_ENABLE, CONFIG_ALIF_PM_SLEEP_ENABLE),
+	NVDS_TLV1(BOOT_PARAM_ID_EXT_WAKEUP_ENABLE, CONFIG_ALIF_PM_EXT_WAKEUP_ENABLE),
+	NVDS_TLV1(BOOT_PARAM_ID_ENABLE_CHANNEL_ASSESSMENT, CONFIG_ALIF_PM_ENABLE_CH_ASSESSMENT),
+	NVDS_TLV1(BOOT_PARAM_ID_RSSI_INTERF_THR, CONFIG_ALIF_PM_RSSI_INTERF_THR),
+	NVDS_TLV4(BOOT_PARAM_ID_UART_BAUDRATE, ES0_BAUDRATE),
+	NVDS_TLV2(BOOT_PARAM_ID_EXT_WAKEUP_TIME, CONFIG_ALIF_EXT_WAKEUP_TIME),
+	NVDS_TLV2(BOOT_PARAM_ID_OSC_WAKEUP_TIME, CONFIG_ALIF_OSC_WAKEUP_TIME),
+	NVDS_TLV2(BOOT_PARAM_ID_RM_WAKEUP_TIME, CONFIG_ALIF_RM_WAKEUP_TIME),
+	NVDS_TLV2(BOOT_PARAM_ID_EXT_WARMBOOT_WAKEUP_TIME, CONFIG_ALIF_EXT_WARMBOOT_WAKEUP_TIME),
+	NVDS_TLV2(BOOT_PARAM_ID_LPCLK_DRIFT, CONFIG_ALIF_MAX_SLEEP_CLOCK_DRIFT),
+	NVDS_TLV1(BOOT_PARAM_ID_ACTCLK_DRIFT, CONFIG_ALIF_MAX_ACTIVE_CLOCK_DRIFT),
+	NVDS_TLV4(BOOT_PARAM_ID_UART_INPUT_CLK_FREQ, ES0_UART_CLK_FREQ),
+	NVDS_TLV_HDR(BOOT_PARAM_ID_NO_PARAM, 0),
+};
+
+BUILD_ASSERT(sizeof(nvds_template) <= LL_BOOT_PARAMS_MAX_SIZE, "Too many ES0 boot parameters");
+
+#define NVDS_CACHE_MAGIC 0x4E564453
+
+/* Boot parameters of the previous ES0 start, reused on later starts */
+struct nvds_cache {
+	uint32_t magic;
+	uint32_t crc;
+	uint8_t blob[sizeof(nvds_template)] __aligned(4);
+};
+
+#if defined(CONFIG_ALIF_PM_NVDS_CACHE_RETAINED)
+static __noinit struct nvds_cache nvds_cache;
+#else
+static struct nvds_cache nvds_cache;
+#endif
+
+static bool nvds_cache_valid(void)
+{
+	const size_t tail = NVDS_BD_ADDR_OFFSET + BOOT_PARAM_LEN_BD_ADDRESS;
 
+	if (nvds_cache.magic != NVDS_CACHE_MAGIC ||
+	    nvds_cache.crc != crc32_ieee(nvds_cache.blob, sizeof(nvds_cache.blob))) {
+		return false;
+	}
+	/* Retained blob may come from firmware with different configuration */
+	return memcmp(nvds_cache.blob, nvds_template, NVDS_BD_ADDR_OFFSET) == 0 &&
+	       memcmp(&nvds_cache.blob[tail], &nvds_template[tail],
+		      sizeof(nvds_template) - tail) == 0;
 }
 
-int8_t take_es0_into_use(void)
+static uint8_t *nvds_blob_get(void)
 {
-	if (255 == es0_user_counter) {
-		return ES0_PM_ERROR_TOO_MANY_USERS;
+	uint8_t bd_address[BOOT_PARAM_LEN_BD_ADDRESS];
+
+	if (nvds_cache_valid()) {
+		return nvds_cache.blob;
 	}
 
-	uint32_t hci_baudrate;
-	uint32_t ahi_baudrate;
-	uint32_t used_baudrate;
+	/* Only the BD address needs SE services */
+	alif_eui48_read(bd_address);
 
-	hci_baudrate = DT_PROP_OR(DT_CHOSEN(zephyr_hci_uart), current_speed, 0);
-	ahi_baudrate = DT_PROP_OR(DT_CHOSEN(zephyr_ahi_uart), current_speed, 0);
+	memcpy(nvds_cache.blob, nvds_template, sizeof(nvds_template));
+	memcpy(&nvds_cache.blob[NVDS_BD_ADDR_OFFSET], bdaddr_reverse(bd_address),
+	       BOOT_PARAM_LEN_BD_ADDRESS);
+	nvds_cache.crc = crc32_ieee(nvds_cache.blob, sizeof(nvds_cache.blob));
+	nvds_cache.magic = NVDS_CACHE_MAGIC;
 
-	if (!hci_baudrate && !ahi_baudrate) {
-		return ES0_PM_ERROR_NO_BAUDRATE;
+	/* SE copies the blob from memory */
+	sys_cache_data_flush_range(nvds_cache.blob, sizeof(nvds_cache.blob));
+
+	return nvds_cache.blob;
+}
+
+/**
+ * @brief Drop cached boot parameters, next ES0 start rebuilds them.
+ */
+void es0_boot_params_invalidate(void)
+{
+	nvds_cache.magic = 0;
+}
+
+/* A failed shutdown still ends the run, next use boots ES0 from scratch */
+static int es0_shutdown(void)
+{
+	int err = se_service_shutdown_es0();
+
+	if (err) {
+		LOG_ERR("ES0 shutdown failed (%d), rebooting it on next use", err);
+	} else {
+		es0_stats.shutdowns++;
 	}
+	es0_shutdown_failed = (err != 0);
+	es0_running = false;
+	atomic_set(&es0_wake_state, ES0_WAKE_ASLEEP);
+	es0_stats.on_time_ms += k_uptime_get() - es0_boot_time;
+	return err;
+}
 
-	if (hci_baudrate && ahi_baudrate && hci_baudrate != ahi_baudrate) {
-		return ES0_PM_ERROR_BAUDRATE_MISMATCH;
+/**
+ * @brief Learn linger time from gaps between release and next use.
+ *
+ * Gaps longer than the maximum linger time pull the average down, so the
+ * linger time shrinks back to the minimum when ES0 is used rarely.
+ */
+static void es0_gap_record(uint32_t gap_ms)
+{
+	uint32_t sample = gap_ms <= ES0_LINGER_MAX_MS ? gap_ms : 0;
+
+	es0_gap_avg_ms = (3 * es0_gap_avg_ms + sample) / 4;
+	es0_stats.linger_ms = CLAMP(2 * es0_gap_avg_ms, ES0_LINGER_MIN_MS, ES0_LINGER_MAX_MS);
+}
+
+static void es0_linger_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&es0_lock, K_FOREVER);
+	/* New user may have arrived while waiting for the lock */
+	if (es0_user_counter == 0 && es0_running) {
+		/* Failure is logged and handled by a reboot on next use */
+		(void)es0_shutdown();
 	}
+	k_mutex_unlock(&es0_lock);
+}
 
-	used_baudrate = hci_baudrate ? hci_baudrate : ahi_baudrate;
+static int8_t es0_acquire(void)
+{
+	if (255 == es0_user_counter) {
+		return ES0_PM_ERROR_TOO_MANY_USERS;
+	}
 
-	if (es0_user_counter == 0) {
-		int err;
-		uint32_t version;
+	if (!HCI_BAUDRATE && !AHI_BAUDRATE) {
+		return ES0_PM_ERROR_NO_BAUDRATE;
+	}
 
-		err = se_service_get_toc_version(&version);
-		if (err) {
-			return err;
-		}
-		/* v1.103. not need shuttdown */
-		if (version < 0x01670000) {
-			/* Shuttdown is needed if riscv was already active */
-			se_service_shutdown_es0();
-		}
-	} else {
+	if (HCI_BAUDRATE && AHI_BAUDRATE && HCI_BAUDRATE != AHI_BAUDRATE) {
+		return ES0_PM_ERROR_BAUDRATE_MISMATCH;
+	}
+
+	if (es0_user_counter) {
 		/* Already started */
 		es0_user_counter++;
 		return ES0_PM_ERROR_NO_ERROR;
 	}
 
-	static uint8_t ll_boot_params_buffer[LL_BOOT_PARAMS_MAX_SIZE];
-
-	memset(ll_boot_params_buffer, 0xFF, LL_BOOT_PARAMS_MAX_SIZE);
-	uint8_t *ptr = ll_boot_params_buffer;
-	*ptr++ = 'N';
-	*ptr++ = 'V';
-	*ptr++ = 'D';
-	*ptr++ = 'S';
-
-	uint16_t total_length = 4; /* N,V,D,S */
-
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_LE_CODED_PHY_500);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_DFT_SLAVE_MD);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_CH_CLASS_REP_INTV);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_BD_ADDRESS);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_ACTIVITY_MOVE_CONFIG);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_SCAN_EXT_ADV);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_RSSI_THR);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_RSSI_THR);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_SLEEP_ENABLE);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_EXT_WAKEUP_ENABLE);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_ENABLE_CHANNEL_ASSESSMENT);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_RSSI_THR);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_UART_BAUDRATE);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_UART_INPUT_CLK_FREQ);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_EXT_WAKEUP_TIME);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_OSC_WAKEUP_TIME);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_RM_WAKEUP_TIME);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_EXT_WARMBOOT_WAKEUP_TIME);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_LPCLK_DRIFT);
-	total_length += add_nvds_param_length(BOOT_PARAM_LEN_ACTCLK_DRIFT);
-
-	if (total_length > LL_BOOT_PARAMS_MAX_SIZE) {
-		return ES0_PM_ERROR_TOO_MANY_BOOT_PARAMS;
+	if (IS_ENABLED(CONFIG_ALIF_PM_ES0_LINGER) && es0_release_time) {
+		es0_gap_record(k_uptime_get() - es0_release_time);
 	}
 
-	uint8_t bd_address[BOOT_PARAM_LEN_BD_ADDRESS];
+	if (es0_running) {
+		/* Still lingering after last release, no need to boot */
+		k_work_cancel_delayable(&es0_linger_work);
+		es0_stats.boots_avoided++;
+		es0_user_counter++;
+		return ES0_PM_ERROR_NO_ERROR;
+	}
 
-	alif_eui48_read(bd_address);
+	int err;
+	uint32_t version;
+	uint32_t start = k_cycle_get_32();
 
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_LE_CODED_PHY_500, CONFIG_ALIF_PM_LE_CODED_PHY_500,
-			    BOOT_PARAM_LEN_LE_CODED_PHY_500);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_DFT_SLAVE_MD, CONFIG_ALIF_PM_DFT_SLAVE_MD,
-			    BOOT_PARAM_LEN_DFT_SLAVE_MD);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_CH_CLASS_REP_INTV, CONFIG_ALIF_PM_CH_CLASS_REP_INTV,
-			    BOOT_PARAM_LEN_CH_CLASS_REP_INTV);
-	ptr = write_tlv_str(ptr, BOOT_PARAM_ID_BD_ADDRESS, bdaddr_reverse(bd_address),
-			    BOOT_PARAM_LEN_BD_ADDRESS);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_ACTIVITY_MOVE_CONFIG,
-			    CONFIG_ALIF_PM_ACTIVITY_MOVE_CONFIG,
-			    BOOT_PARAM_LEN_ACTIVITY_MOVE_CONFIG);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_SCAN_EXT_ADV, CONFIG_ALIF_PM_SCAN_EXT_ADV,
-			    BOOT_PARAM_LEN_SCAN_EXT_ADV);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_RSSI_HIGH_THR, CONFIG_ALIF_PM_RSSI_HIGH_THR,
-			    BOOT_PARAM_LEN_RSSI_THR);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_RSSI_LOW_THR, CONFIG_ALIF_PM_RSSI_LOW_THR,
-			    BOOT_PARAM_LEN_RSSI_THR);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_SLEEP_ENABLE, CONFIG_ALIF_PM_SLEEP_ENABLE,
-			    BOOT_PARAM_LEN_SLEEP_ENABLE);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_EXT_WAKEUP_ENABLE, CONFIG_ALIF_PM_EXT_WAKEUP_ENABLE,
-			    BOOT_PARAM_LEN_EXT_WAKEUP_ENABLE);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_ENABLE_CHANNEL_ASSESSMENT,
-			    CONFIG_ALIF_PM_ENABLE_CH_ASSESSMENT,
-			    BOOT_PARAM_LEN_ENABLE_CHANNEL_ASSESSMENT);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_RSSI_INTERF_THR, CONFIG_ALIF_PM_RSSI_INTERF_THR,
-			    BOOT_PARAM_LEN_RSSI_THR);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_UART_BAUDRATE, used_baudrate,
-			    BOOT_PARAM_LEN_UART_BAUDRATE);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_EXT_WAKEUP_TIME, CONFIG_ALIF_EXT_WAKEUP_TIME,
-			    BOOT_PARAM_LEN_EXT_WAKEUP_TIME);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_OSC_WAKEUP_TIME, CONFIG_ALIF_OSC_WAKEUP_TIME,
-			    BOOT_PARAM_LEN_OSC_WAKEUP_TIME);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_RM_WAKEUP_TIME, CONFIG_ALIF_RM_WAKEUP_TIME,
-			    BOOT_PARAM_LEN_RM_WAKEUP_TIME);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_EXT_WARMBOOT_WAKEUP_TIME,
-			    CONFIG_ALIF_EXT_WARMBOOT_WAKEUP_TIME,
-			    BOOT_PARAM_LEN_EXT_WARMBOOT_WAKEUP_TIME);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_LPCLK_DRIFT, CONFIG_ALIF_MAX_SLEEP_CLOCK_DRIFT,
-			    BOOT_PARAM_LEN_LPCLK_DRIFT);
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_ACTCLK_DRIFT, CONFIG_ALIF_MAX_ACTIVE_CLOCK_DRIFT,
-			    BOOT_PARAM_LEN_ACTCLK_DRIFT);
-
-	uint32_t min_uart_clk_freq = used_baudrate * 16;
-	uint32_t reg_uart_clk_cfg = LL_UART_CLK_SEL_CTRL_16MHZ;
-	uint32_t ll_uart_clk_freq = 16000000;
-	uint32_t es0_clock_select = CONFIG_SE_SERVICE_RF_CORE_FREQUENCY;
-
-	/* UART input clock can be configured as 16/24/48Mhz */
-	if (min_uart_clk_freq > 16000000) {
-		if (min_uart_clk_freq <= 24000000) {
-			ll_uart_clk_freq = 24000000;
-			reg_uart_clk_cfg = LL_UART_CLK_SEL_CTRL_24MHZ;
-		} else {
-			ll_uart_clk_freq = 48000000;
-			reg_uart_clk_cfg = LL_UART_CLK_SEL_CTRL_48MHZ;
-		}
+	err = se_service_get_toc_version(&version);
+	if (err) {
+		return err;
 	}
-	/* Add UART clock slect */
-	es0_clock_select |= reg_uart_clk_cfg;
-	ptr = write_tlv_int(ptr, BOOT_PARAM_ID_UART_INPUT_CLK_FREQ, ll_uart_clk_freq,
-			    BOOT_PARAM_LEN_UART_INPUT_CLK_FREQ);
-
-	if (total_length < (LL_BOOT_PARAMS_MAX_SIZE - 2)) {
-		ptr = write_tlv_int(ptr, BOOT_PARAM_ID_NO_PARAM, 0, 0);
-		total_length += 3;
+	/* v1.103. not need shuttdown, unless the last shutdown failed */
+	if (version < 0x01670000 || es0_shutdown_failed) {
+		/* Shuttdown is needed if riscv was already active */
+		se_service_shutdown_es0();
+		es0_shutdown_failed = false;
 	}
 
-	if (total_length != (ptr - ll_boot_params_buffer)) {
+	if (nvds_template[NVDS_BD_ADDR_OFFSET - 3] != BOOT_PARAM_ID_BD_ADDRESS) {
 		return ES0_PM_ERROR_INVALID_BOOT_PARAMS;
 	}
 
-	if (se_service_boot_es0(ll_boot_params_buffer, total_length, es0_clock_select)) {
+	/* Add UART clock slect */
+	uint32_t es0_clock_select = CONFIG_SE_SERVICE_RF_CORE_FREQUENCY | ES0_UART_CLK_SEL;
+
+	if (se_service_boot_es0(nvds_blob_get(), sizeof(nvds_template), es0_clock_select)) {
 		return ES0_PM_ERROR_START_FAILED;
 	}
 
+	es0_running = true;
+	es0_boot_time = k_uptime_get();
+	/* Freshly booted core waits for the first wake up edge */
+	atomic_set(&es0_wake_state, ES0_WAKE_ASLEEP);
+	es0_stats.boots++;
+	es0_stats.last_boot_us = k_cyc_to_us_ceil32(k_cycle_get_32() - start);
+	es0_stats.max_boot_us = MAX(es0_stats.max_boot_us, es0_stats.last_boot_us);
+
 	es0_user_counter++;
 	return ES0_PM_ERROR_NO_ERROR;
 }
 
+int8_t take_es0_into_use(void)
+{
+	int8_t ret;
+
+	k_mutex_lock(&es0_lock, K_FOREVER);
+	ret = es0_acquire();
+	k_mutex_unlock(&es0_lock);
+
+	return ret;
+}
+
 int8_t stop_using_es0(void)
 {
+	int8_t ret = 0;
+
+	k_mutex_lock(&es0_lock, K_FOREVER);
 	if (!es0_user_counter) {
+		k_mutex_unlock(&es0_lock);
 		return -1;
 	}
 	es0_user_counter--;
 	if (!es0_user_counter) {
-		if (se_service_shutdown_es0()) {
-			return -2;
+		es0_release_time = k_uptime_get();
+		if (IS_ENABLED(CONFIG_ALIF_PM_ES0_LINGER)) {
+			/* Shutdown is done later unless a new user arrives */
+			k_work_reschedule(&es0_linger_work, K_MSEC(es0_stats.linger_ms));
+		} else if (es0_shutdown()) {
+			ret = -2;
 		}
 	}
+	k_mutex_unlock(&es0_lock);
+
+	return ret;
+}
+
+void es0_pm_stats_get(struct es0_pm_stats *p_stats)
+{
+	k_mutex_lock(&es0_lock, K_FOREVER);
+	k_spinlock_key_t key;
+
+	*p_stats = es0_stats;
+	if (es0_running) {
+		p_stats->on_time_ms += k_uptime_get() - es0_boot_time;
+	}
+	k_mutex_unlock(&es0_lock);
+
+	key = k_spin_lock(&es0_wake_lock);
+	p_stats->wakeups = es0_stats.wakeups;
+	p_stats->wake_skipped = atomic_get(&es0_wake_skipped);
+	p_stats->wake_overlapped = es0_wake_overlapped;
+	p_stats->last_wake_us = es0_stats.last_wake_us;
+	p_stats->max_wake_us = es0_stats.max_wake_us;
+	k_spin_unlock(&es0_wake_lock, key);
+}
 
-	return 0;
+static void es0_wake_pulse(const struct device *uart_dev)
+{
+	uart_line_ctrl_set(uart_dev, UART_LINE_CTRL_RTS, 0);
+	/* Pulse width only, a tick based sleep would round up to a full tick */
+	k_busy_wait(CONFIG_ALIF_PM_ES0_WAKE_PULSE_US);
+	uart_line_ctrl_set(uart_dev, UART_LINE_CTRL_RTS, 1);
+}
+
+/*
+ * The link layer sends no sleep indication and CTS cannot be read through
+ * the UART API, so an idle link layer is taken to have gone back to sleep.
+ */
+static bool es0_idle_expired(uint32_t now_ms)
+{
+	if (!CONFIG_ALIF_PM_SLEEP_ENABLE) {
+		return false;
+	}
+	return now_ms - (uint32_t)atomic_get(&es0_activity_ms) >=
+	       CONFIG_ALIF_PM_ES0_SLEEP_TIMEOUT_MS;
 }
 
 void wake_es0(const struct device *uart_dev)
 {
-	if (wakeup_count == 0) {
-		uart_line_ctrl_set(uart_dev, UART_LINE_CTRL_RTS, 0);
-		k_usleep(100);
-		uart_line_ctrl_set(uart_dev, UART_LINE_CTRL_RTS, 1);
-		wakeup_count++;
+	k_spinlock_key_t key;
+	uint32_t start, wake_us;
+	uint32_t now_ms = k_uptime_get_32();
+	atomic_val_t state = atomic_get(&es0_wake_state);
+
+	/* Hot path of every transport call, ES0 is awake and recently used */
+	if (state == ES0_WAKE_AWAKE && !es0_idle_expired(now_ms)) {
+		atomic_set(&es0_activity_ms, now_ms);
+		atomic_inc(&es0_wake_skipped);
+		return;
+	}
+
+	/* Asleep after boot, or idle long enough to have fallen asleep */
+	if (state == ES0_WAKE_WAKING || !atomic_cas(&es0_wake_state, state, ES0_WAKE_WAKING)) {
+		/*
+		 * Another caller is in the middle of the pulse, possibly the
+		 * thread this ISR preempted, so waiting for it could dead lock.
+		 * Sending a full pulse of our own keeps RTS low long enough
+		 * before this caller goes on to transmit.
+		 */
+		es0_wake_pulse(uart_dev);
+		key = k_spin_lock(&es0_wake_lock);
+		es0_wake_overlapped++;
+		k_spin_unlock(&es0_wake_lock, key);
+		return;
+	}
+
+	start = k_cycle_get_32();
+	es0_wake_pulse(uart_dev);
+	wake_us = k_cyc_to_us_ceil32(k_cycle_get_32() - start);
+	atomic_set(&es0_activity_ms, k_uptime_get_32());
+
+	/* ES0 shutdown or boot during the pulse leaves the state asleep */
+	if (atomic_cas(&es0_wake_state, ES0_WAKE_WAKING, ES0_WAKE_AWAKE)) {
+		key = k_spin_lock(&es0_wake_lock);
+		es0_stats.wakeups++;
+		es0_stats.last_wake_us = wake_us;
+		es0_stats.max_wake_us = MAX(es0_stats.max_wake_us, wake_us);
+		k_spin_unlock(&es0_wake_lock, key);
 	}
 }
@@ -0,0 +1,595 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+#include "mram_rw.h"
+#include "mram_kv.h"
+LOG_MODULE_REGISTER(mram_kv, CONFIG_SOC_LOG_LEVEL);
+
+/*
+ * Bank layout, all offsets relative to the bank start:
+ *
+ *   [bank header][record][record]...[checkpoint][record]...
+ *
+ * A record is a 16-byte header sector followed by its data padded to whole
+ * sectors. The data goes out first and the header sector last, so a record
+ * exists only once its single atomic sector write is done. Every record
+ * carries the bank generation, leftovers from an older use of the bank stop
+ * the scan just like a never written sector.
+ *
+ * Compaction copies the live records into the other bank, appends a
+ * checkpoint listing them and commits by writing that bank's header with
+ * the next generation. Mount picks the valid header with the highest
+ * generation, loads the index from its checkpoint and scans only what was
+ * appended after it.
+ *
+ * Before copying, compaction marks the target bank pending with the
+ * generation it is about to use. Should it be cut short, the next attempt
+ * moves past that generation so the leftover records never look current.
+ */
+
+#define KV_SECTOR         16
+#define KV_BANK_MAGIC     0x4B564D41
+#define KV_BANK_PENDING   0x504B564D
+#define KV_REC_MAGIC      0xA55A
+
+#define KV_REC_DATA       1
+#define KV_REC_DELETE     2
+#define KV_REC_CHECKPOINT 3
+
+#define KV_SLOT_EMPTY     0
+#define KV_SLOT_USED      1
+#define KV_SLOT_TOMB      2
+
+#define KV_INDEX_SIZE     CONFIG_ALIF_MRAM_KV_INDEX_SIZE
+
+BUILD_ASSERT(IS_POWER_OF_TWO(KV_INDEX_SIZE), "MRAM KV index size must be a power of two");
+
+struct kv_bank_hdr {
+	uint32_t magic;
+	uint32_t gen;
+	/* Checkpoint record offset, 0 when the bank has none */
+	uint32_t ckpt_off;
+	uint32_t crc;
+};
+
+struct kv_rec_hdr {
+	uint16_t magic;
+	uint16_t id;
+	uint16_t len;
+	uint8_t type;
+	uint8_t rsvd;
+	uint32_t gen;
+	/* Over the fields above and the data */
+	uint32_t crc;
+};
+
+struct kv_ckpt_entry {
+	uint16_t id;
+	uint16_t rsvd;
+	uint32_t off;
+};
+
+BUILD_ASSERT(sizeof(struct kv_bank_hdr) == KV_SECTOR);
+BUILD_ASSERT(sizeof(struct kv_rec_hdr) == KV_SECTOR);
+BUILD_ASSERT(KV_INDEX_SIZE * sizeof(struct kv_ckpt_entry) <= UINT16_MAX);
+
+static inline uint32_t rec_size(uint32_t len)
+{
+	return KV_SECTOR + ROUND_UP(len, KV_SECTOR);
+}
+
+static inline uint8_t *bank_base(struct mram_kv *kv, uint8_t bank)
+{
+	return kv->area + bank * kv->bank_size;
+}
+
+static inline const struct kv_rec_hdr *rec_at(struct mram_kv *kv, uint32_t off)
+{
+	return (const struct kv_rec_hdr *)(bank_base(kv, kv->bank) + off);
+}
+
+static uint32_t rec_crc(const struct kv_rec_hdr *hdr, const void *data)
+{
+	uint32_t crc = crc32_ieee((const uint8_t *)hdr, offsetof(struct kv_rec_hdr, crc));
+
+	return crc32_ieee_update(crc, data, hdr->len);
+}
+
+static bool rec_valid(struct mram_kv *kv, uint32_t off)
+{
+	const struct kv_rec_hdr *hdr;
+
+	/* Offsets come from MRAM contents too, keep the header in the bank */
+	if (off > kv->bank_size - KV_SECTOR) {
+		return false;
+	}
+	hdr = rec_at(kv, off);
+
+	if (hdr->magic != KV_REC_MAGIC || hdr->gen != kv->gen) {
+		return false;
+	}
+	if (off + rec_size(hdr->len) > kv->bank_size) {
+		return false;
+	}
+	return rec_crc(hdr, hdr + 1) == hdr->crc;
+}
+
+/* Data first, header sector last: the header write is the commit */
+static void rec_write(struct mram_kv *kv, uint8_t bank, uint32_t off, uint16_t id, uint8_t type,
+		      const void *data, uint16_t len)
+{
+	uint8_t *dst = bank_base(kv, bank) + off;
+	struct kv_rec_hdr hdr = {
+		.magic = KV_REC_MAGIC,
+		.id = id,
+		.len = len,
+		.type = type,
+		.gen = kv->gen,
+	};
+
+	if (len) {
+		mram_write(dst + KV_SECTOR, data, len);
+	}
+	hdr.crc = rec_crc(&hdr, data);
+	mram_write(dst, (const uint8_t *)&hdr, sizeof(hdr));
+}
+
+static bool bank_hdr_is(const struct kv_bank_hdr *hdr, uint32_t magic)
+{
+	return hdr->magic == magic &&
+	       crc32_ieee((const uint8_t *)hdr, offsetof(struct kv_bank_hdr, crc)) == hdr->crc;
+}
+
+static inline bool bank_hdr_valid(const struct kv_bank_hdr *hdr)
+{
+	return bank_hdr_is(hdr, KV_BANK_MAGIC);
+}
+
+static void bank_hdr_write(struct mram_kv *kv, uint8_t bank, uint32_t magic, uint32_t gen,
+			   uint32_t ckpt_off)
+{
+	struct kv_bank_hdr hdr = {
+		.magic = magic,
+		.gen = gen,
+		.ckpt_off = ckpt_off,
+	};
+
+	hdr.crc = crc32_ieee((const uint8_t *)&hdr, offsetof(struct kv_bank_hdr, crc));
+	mram_write(bank_base(kv, bank), (const uint8_t *)&hdr, sizeof(hdr));
+}
+
+static inline uint32_t index_hash(uint16_t id)
+{
+	return (id * 2654435761U) >> (32 - LOG2(KV_INDEX_SIZE));
+}
+
+static struct mram_kv_slot *index_find(struct mram_kv *kv, uint16_t id)
+{
+	uint32_t i = index_hash(id);
+
+	for (uint32_t n = 0; n < KV_INDEX_SIZE; n++, i = (i + 1) & (KV_INDEX_SIZE - 1)) {
+		struct mram_kv_slot *slot = &kv->index[i];
+
+		if (slot->state == KV_SLOT_EMPTY) {
+			break;
+		}
+		if (slot->state == KV_SLOT_USED && slot->id == id) {
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+static int index_put(struct mram_kv *kv, uint16_t id, uint32_t off)
+{
+	struct mram_kv_slot *slot = index_find(kv, id);
+	uint32_t i = index_hash(id);
+
+	if (slot) {
+		slot->off = off;
+		return 0;
+	}
+
+	/* First empty or tombstone slot on the probe path */
+	for (uint32_t n = 0; n < KV_INDEX_SIZE; n++, i = (i + 1) & (KV_INDEX_SIZE - 1)) {
+		slot = &kv->index[i];
+		if (slot->state != KV_SLOT_USED) {
+			slot->state = KV_SLOT_USED;
+			slot->id = id;
+			slot->off = off;
+			kv->count++;
+			return 0;
+		}
+	}
+	return -ENOMEM;
+}
+
+static void index_del(struct mram_kv *kv, uint16_t id)
+{
+	struct mram_kv_slot *slot = index_find(kv, id);
+
+	if (slot) {
+		slot->state = KV_SLOT_TOMB;
+		kv->count--;
+	}
+}
+
+static void index_reset(struct mram_kv *kv)
+{
+	memset(kv->index, 0, sizeof(kv->index));
+	kv->count = 0;
+}
+
+/* Replay records from off on, kv->end ends up after the last valid one */
+static int log_scan(struct mram_kv *kv, uint32_t off)
+{
+	int err;
+
+	while (off + KV_SECTOR <= kv->bank_size && rec_valid(kv, off)) {
+		const struct kv_rec_hdr *hdr = rec_at(kv, off);
+
+		if (hdr->type == KV_REC_DATA) {
+			err = index_put(kv, hdr->id, off);
+			if (err) {
+				return err;
+			}
+		} else if (hdr->type == KV_REC_DELETE) {
+			index_del(kv, hdr->id);
+		}
+		off += rec_size(hdr->len);
+	}
+	kv->end = off;
+
+	return 0;
+}
+
+/* Fill the index from the bank's checkpoint, returns where to scan from */
+static uint32_t ckpt_load(struct mram_kv *kv, uint32_t ckpt_off)
+{
+	const struct kv_rec_hdr *hdr;
+	const struct kv_ckpt_entry *entry;
+
+	if (ckpt_off < KV_SECTOR || !rec_valid(kv, ckpt_off)) {
+		return KV_SECTOR;
+	}
+	hdr = rec_at(kv, ckpt_off);
+	if (hdr->type != KV_REC_CHECKPOINT || hdr->len % sizeof(*entry) ||
+	    hdr->len / sizeof(*entry) > KV_INDEX_SIZE) {
+		return KV_SECTOR;
+	}
+
+	entry = (const struct kv_ckpt_entry *)(hdr + 1);
+	for (uint32_t n = 0; n < hdr->len / sizeof(*entry); n++) {
+		uint32_t off = entry[n].off;
+
+		/* A bad entry discards the checkpoint, the replay finds every record */
+		if (off < KV_SECTOR || off >= ckpt_off || !rec_valid(kv, off) ||
+		    rec_at(kv, off)->type != KV_REC_DATA || rec_at(kv, off)->id != entry[n].id) {
+			LOG_WRN("checkpoint entry %u at %u invalid", n, off);
+			index_reset(kv);
+			return KV_SECTOR;
+		}
+		/* Cannot fail, the checkpoint was written from an index this size */
+		(void)index_put(kv, entry[n].id, off);
+	}
+
+	return ckpt_off + rec_size(hdr->len);
+}
+
+static void live_count(struct mram_kv *kv)
+{
+	kv->live = 0;
+	for (uint32_t i = 0; i < KV_INDEX_SIZE; i++) {
+		if (kv->index[i].state == KV_SLOT_USED) {
+			kv->live += rec_size(rec_at(kv, kv->index[i].off)->len);
+		}
+	}
+}
+
+static int compact_locked(struct mram_kv *kv)
+{
+	uint8_t dst_bank = !kv->bank;
+	uint8_t *src = bank_base(kv, kv->bank);
+	uint32_t ckpt_len = kv->count * sizeof(struct kv_ckpt_entry);
+	struct kv_ckpt_entry chunk[4];
+	struct kv_rec_hdr hdr;
+	uint32_t off = KV_SECTOR;
+	uint32_t ckpt_off, crc, n = 0;
+
+	if (KV_SECTOR + kv->live + rec_size(ckpt_len) > kv->bank_size) {
+		/* Retrying cannot help before a delete frees some space */
+		kv->compact_blocked = true;
+		return -ENOSPC;
+	}
+
+	kv->gen = kv->next_gen;
+	bank_hdr_write(kv, dst_bank, KV_BANK_PENDING, kv->gen, 0);
+
+	/* Live records, re-stamped with the new generation */
+	for (uint32_t i = 0; i < KV_INDEX_SIZE; i++) {
+		struct mram_kv_slot *slot = &kv->index[i];
+		const struct kv_rec_hdr *old;
+
+		if (slot->state != KV_SLOT_USED) {
+			continue;
+		}
+		old = (const struct kv_rec_hdr *)(src + slot->off);
+		rec_write(kv, dst_bank, off, old->id, KV_REC_DATA, old + 1, old->len);
+		slot->off = off;
+		off += rec_size(old->len);
+	}
+
+	/* Checkpoint, streamed out of the index a few entries at a time */
+	ckpt_off = off;
+	hdr = (struct kv_rec_hdr){
+		.magic = KV_REC_MAGIC,
+		.len = ckpt_len,
+		.type = KV_REC_CHECKPOINT,
+		.gen = kv->gen,
+	};
+	crc = crc32_ieee((const uint8_t *)&hdr, offsetof(struct kv_rec_hdr, crc));
+	off += KV_SECTOR;
+
+	for (uint32_t i = 0; i < KV_INDEX_SIZE; i++) {
+		if (kv->index[i].state != KV_SLOT_USED) {
+			continue;
+		}
+		chunk[n].id = kv->index[i].id;
+		chunk[n].rsvd = 0;
+		chunk[n].off = kv->index[i].off;
+		if (++n == ARRAY_SIZE(chunk)) {
+			crc = crc32_ieee_update(crc, (const uint8_t *)chunk, sizeof(chunk));
+			mram_write(bank_base(kv, dst_bank) + off, (const uint8_t *)chunk,
+				   sizeof(chunk));
+			off += sizeof(chunk);
+			n = 0;
+		}
+	}
+	if (n) {
+		crc = crc32_ieee_update(crc, (const uint8_t *)chunk, n * sizeof(chunk[0]));
+		mram_write(bank_base(kv, dst_bank) + off, (const uint8_t *)chunk,
+			   n * sizeof(chunk[0]));
+	}
+	hdr.crc = crc;
+	mram_write(bank_base(kv, dst_bank) + ckpt_off, (const uint8_t *)&hdr, sizeof(hdr));
+
+	/* Commit point, the new bank wins from here on */
+	bank_hdr_write(kv, dst_bank, KV_BANK_MAGIC, kv->gen, ckpt_off);
+
+	kv->bank = dst_bank;
+	kv->next_gen = kv->gen + 1;
+	kv->end = ckpt_off + rec_size(ckpt_len);
+	kv->ckpt_size = rec_size(ckpt_len);
+	kv->compact_blocked = false;
+
+	/* Drop the tombstones */
+	index_reset(kv);
+	(void)ckpt_load(kv, ckpt_off);
+	live_count(kv);
+
+	LOG_DBG("compacted to bank %u gen %u, %u bytes live", kv->bank, kv->gen, kv->live);
+
+	return 0;
+}
+
+static void compact_maybe(struct mram_kv *kv)
+{
+	/* The checkpoint is not garbage, only compaction can shrink it */
+	uint32_t garbage = kv->end - KV_SECTOR - kv->live - kv->ckpt_size;
+
+	if (kv->compact_blocked) {
+		return;
+	}
+	if (garbage * 100 > kv->bank_size * CONFIG_ALIF_MRAM_KV_COMPACT_PERCENT) {
+		k_work_submit(&kv->compact_work);
+	}
+}
+
+static void compact_work_handler(struct k_work *work)
+{
+	struct mram_kv *kv = CONTAINER_OF(work, struct mram_kv, compact_work);
+	int err;
+
+	err = mram_kv_compact(kv);
+	if (err) {
+		LOG_WRN("background compaction failed (%d)", err);
+	}
+}
+
+/* Append a record, compacting first when the bank is full */
+static int append_locked(struct mram_kv *kv, uint16_t id, uint8_t type, const void *data,
+			 uint16_t len)
+{
+	uint32_t need = rec_size(len);
+	int err;
+
+	if (kv->end + need > kv->bank_size) {
+		err = compact_locked(kv);
+		if (err) {
+			return err;
+		}
+		if (kv->end + need > kv->bank_size) {
+			return -ENOSPC;
+		}
+	}
+
+	rec_write(kv, kv->bank, kv->end, id, type, data, len);
+	kv->end += need;
+
+	return 0;
+}
+
+int mram_kv_mount(struct mram_kv *kv, uint8_t *area, size_t size)
+{
+	const struct kv_bank_hdr *hdr[2];
+	uint32_t scan_off;
+	int err;
+
+	if (kv == NULL || area == NULL || ((uint32_t)area % KV_SECTOR) ||
+	    size % (2 * KV_SECTOR) || size < 4 * KV_SECTOR) {
+		return -EINVAL;
+	}
+
+	k_mutex_init(&kv->lock);
+	k_work_init(&kv->compact_work, compact_work_handler);
+	kv->area = area;
+	kv->bank_size = size / 2;
+	kv->compact_blocked = false;
+	index_reset(kv);
+
+	hdr[0] = (const struct kv_bank_hdr *)bank_base(kv, 0);
+	hdr[1] = (const struct kv_bank_hdr *)bank_base(kv, 1);
+
+	if (!bank_hdr_valid(hdr[0]) && !bank_hdr_valid(hdr[1])) {
+		LOG_INF("formatting %zu bytes at %p", size, area);
+		kv->bank = 0;
+		kv->gen = 1;
+		kv->next_gen = 2;
+		bank_hdr_write(kv, 0, KV_BANK_MAGIC, kv->gen, 0);
+		kv->end = KV_SECTOR;
+		kv->live = 0;
+		kv->ckpt_size = 0;
+		return 0;
+	}
+
+	/* Newest committed bank, a compaction cut short never got its header */
+	if (!bank_hdr_valid(hdr[1]) ||
+	    (bank_hdr_valid(hdr[0]) && (int32_t)(hdr[0]->gen - hdr[1]->gen) > 0)) {
+		kv->bank = 0;
+	} else {
+		kv->bank = 1;
+	}
+	kv->gen = hdr[kv->bank]->gen;
+	kv->next_gen = kv->gen + 1;
+	if (bank_hdr_is(hdr[!kv->bank], KV_BANK_PENDING) &&
+	    (int32_t)(hdr[!kv->bank]->gen - kv->gen) > 0) {
+		kv->next_gen = hdr[!kv->bank]->gen + 1;
+	}
+
+	/* Without a usable checkpoint the whole bank is replayed */
+	scan_off = ckpt_load(kv, hdr[kv->bank]->ckpt_off);
+	kv->ckpt_size = (scan_off == KV_SECTOR) ? 0 : scan_off - hdr[kv->bank]->ckpt_off;
+	err = log_scan(kv, scan_off);
+	if (err) {
+		return err;
+	}
+	live_count(kv);
+
+	LOG_DBG("bank %u gen %u, %u ids, %u of %u bytes used", kv->bank, kv->gen, kv->count,
+		kv->end, kv->bank_size);
+
+	compact_maybe(kv);
+
+	return 0;
+}
+
+ssize_t mram_kv_read(struct mram_kv *kv, uint16_t id, void *data, size_t len)
+{
+	const struct kv_rec_hdr *hdr;
+	struct mram_kv_slot *slot;
+	ssize_t ret;
+
+	k_mutex_lock(&kv->lock, K_FOREVER);
+	slot = index_find(kv, id);
+	if (slot == NULL) {
+		k_mutex_unlock(&kv->lock);
+		return -ENOENT;
+	}
+	hdr = rec_at(kv, slot->off);
+	memcpy(data, hdr + 1, MIN(len, hdr->len));
+	ret = hdr->len;
+	k_mutex_unlock(&kv->lock);
+
+	return ret;
+}
+
+int mram_kv_write(struct mram_kv *kv, uint16_t id, const void *data, size_t len)
+{
+	const struct kv_rec_hdr *old = NULL;
+	struct mram_kv_slot *slot;
+	uint32_t off;
+	int err;
+
+	if (len > UINT16_MAX || (len && data == NULL)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&kv->lock, K_FOREVER);
+
+	slot = index_find(kv, id);
+	if (slot) {
+		old = rec_at(kv, slot->off);
+		if (old->len == len && memcmp(old + 1, data, len) == 0) {
+			k_mutex_unlock(&kv->lock);
+			return 0;
+		}
+	} else if (kv->count == KV_INDEX_SIZE) {
+		k_mutex_unlock(&kv->lock);
+		return -ENOMEM;
+	}
+
+	err = append_locked(kv, id, KV_REC_DATA, data, len);
+	if (err) {
+		k_mutex_unlock(&kv->lock);
+		return err;
+	}
+
+	/* Compaction may have moved the old record, look it up again */
+	off = kv->end - rec_size(len);
+	slot = index_find(kv, id);
+	if (slot) {
+		kv->live -= rec_size(rec_at(kv, slot->off)->len);
+	}
+	err = index_put(kv, id, off);
+	kv->live += rec_size(len);
+
+	compact_maybe(kv);
+	k_mutex_unlock(&kv->lock);
+
+	return err;
+}
+
+int mram_kv_delete(struct mram_kv *kv, uint16_t id)
+{
+	struct mram_kv_slot *slot;
+	int err;
+
+	k_mutex_lock(&kv->lock, K_FOREVER);
+
+	if (index_find(kv, id) == NULL) {
+		k_mutex_unlock(&kv->lock);
+		return 0;
+	}
+
+	err = append_locked(kv, id, KV_REC_DELETE, NULL, 0);
+	if (err == 0) {
+		slot = index_find(kv, id);
+		kv->live -= rec_size(rec_at(kv, slot->off)->len);
+		index_del(kv, id);
+		kv->compact_blocked = false;
+		compact_maybe(kv);
+	}
+
+	k_mutex_unlock(&kv->lock);
+
+	return err;
+}
+
+int mram_kv_compact(struct mram_kv *kv)
+{
+	int err;
+
+	k_mutex_lock(&kv->lock, K_FOREVER);
+	err = compact_locked(kv);
+	k_mutex_unlock(&kv->lock);
+
+	return err;
+}
@@ -8,10 +8,48 @@
 #include <cmsis_core.h>
 #include <errno.h>
 #include <zephyr/cache.h>
+#include <zephyr/sys/util.h>
 #include <zephyr/logging/log.h>
+#include "mram_rw.h"
 LOG_MODULE_REGISTER(mram_rw, CONFIG_SOC_LOG_LEVEL);
 
 #define MRAM_UNIT_SECTOR_SIZE 16
+#define MRAM_SECTOR_MASK      (MRAM_UNIT_SECTOR_SIZE - 1)
+
+/* Both halves of a sector must reach MRAM back to back, interrupts off */
+static inline void mram_store_sector(uint8_t *dst, const uint8_t *src)
+{
+	uint64_t tmp_buf[2];
+
+	if ((uint32_t)src & 0x7) {
+		memcpy(tmp_buf, src, MRAM_UNIT_SECTOR_SIZE);
+		src = (const uint8_t *)tmp_buf;
+	}
+	((volatile uint64_t *)dst)[0] = ((const uint64_t *)src)[0];
+	((volatile uint64_t *)dst)[1] = ((const uint64_t *)src)[1];
+}
+
+static void mram_commit(uint8_t *dst, size_t len)
+{
+	__asm__ volatile("dmb 0xF" ::: "memory");
+#if defined(CONFIG_CACHE_MANAGEMENT)
+	sys_cache_data_flush_range(dst, len);
+#endif
+}
+
+/* Read-modify-write of part of one sector */
+static void mram_write_partial(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	uint8_t *sector = (uint8_t *)((uint32_t)dst & ~MRAM_SECTOR_MASK);
+	uint64_t buf[2];
+
+	__disable_irq();
+	memcpy(buf, sector, MRAM_UNIT_SECTOR_SIZE);
+	memcpy((uint8_t *)buf + (dst - sector), src, len);
+	mram_store_sector(sector, (const uint8_t *)buf);
+	mram_commit(sector, MRAM_UNIT_SECTOR_SIZE);
+	__enable_irq();
+}
 
 /**
  * @brief write 16 bytes of data into MRAM
@@ -71,3 +109,58 @@ int erase_16bytes(uint8_t *dst)
 	__enable_irq();
 	return 0;
 }
+/**
+ * @brief write any number of bytes into MRAM
+ *
+ * A partial sector at either end is read, merged and written back. Whole
+ * sectors go out in batches of CONFIG_ALIF_MRAM_WRITE_BATCH_SECTORS with one
+ * cache flush per batch, interrupts are only off for one batch at a time.
+ *
+ * @param dst MRAM address where data is written, any alignment.
+ * @param src Pointer to source containing data to be written.
+ * @param len Number of bytes to write.
+ *
+ * @return 0 if successful.
+ * @return -EINVAL if dst or src is NULL.
+ */
+int mram_write(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	size_t head, batch, i;
+
+	if (dst == NULL || src == NULL) {
+		return -EINVAL;
+	}
+
+	/* Unaligned head up to the first sector boundary */
+	head = (MRAM_UNIT_SECTOR_SIZE - ((uint32_t)dst & MRAM_SECTOR_MASK)) & MRAM_SECTOR_MASK;
+	head = MIN(head, len);
+	if (head) {
+		mram_write_partial(dst, src, head);
+		dst += head;
+		src += head;
+		len -= head;
+	}
+
+	/* Whole sectors, a bounded batch per interrupt-off window */
+	while (len >= MRAM_UNIT_SECTOR_SIZE) {
+		batch = MIN(len / MRAM_UNIT_SECTOR_SIZE, CONFIG_ALIF_MRAM_WRITE_BATCH_SECTORS);
+
+		__disable_irq();
+		for (i = 0; i < batch; i++) {
+			mram_store_sector(&dst[i * MRAM_UNIT_SECTOR_SIZE],
+					  &src[i * MRAM_UNIT_SECTOR_SIZE]);
+		}
+		mram_commit(dst, batch * MRAM_UNIT_SECTOR_SIZE);
+		__enable_irq();
+
+		dst += batch * MRAM_UNIT_SECTOR_SIZE;
+		src += batch * MRAM_UNIT_SECTOR_SIZE;
+		len -= batch * MRAM_UNIT_SECTOR_SIZE;
+	}
+
+	if (len) {
+		mram_write_partial(dst, src, len);
+	}
+
+	return 0;
+}
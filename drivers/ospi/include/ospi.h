@@ -376,6 +376,11 @@ enum spi_transfer_status {
 	SPI_TRANSFER_STATUS_RX_UNDERFLOW,       /* Status Rx underflow */
 };
 
+struct ospi_segment {
+	void                *buff;              /* Data buffer */
+	uint32_t            num;                /* Frames in this buffer */
+};
+
 /**
  * struct ospi_transfer.
  * Information about an ongoing OSPI transfer.
@@ -395,6 +400,11 @@ struct ospi_transfer {
 	bool                tx_default_enable;  /* Enable Tx default */
 	enum spi_tmode      mode;               /* SPI transfer mode */
 	enum spi_transfer_status    status;    /* transfer status */
+	uint32_t            rx_packed_len;      /* 8-bit Rx in 32-bit frames */
+
+	/**Scatter-gather data, NULL for one linear buffer*/
+	const struct ospi_segment *seg;         /* Next data segment */
+	uint32_t            seg_left;           /* Frames left in buffer */
 
 	/**XiP Configuration*/
 	uint16_t            wrap_cmd;           /* WRAP OpCode */
@@ -415,6 +425,11 @@ struct ospi_xip_config {
 	uint16_t                xip_cnt_time_out;    /* Timeout value */
 	uint16_t                xip_wait_cycles;     /* Dummy cycles*/
 	uint16_t                xip_rxds_vl_en;      /* Enable RxDS_VL_EN bit */
+	uint8_t                 xip_prefetch_en;     /* Prefetch next line */
+	uint8_t                 xip_cont_xfer_en;    /* Continuous transfer */
+	uint8_t                 xip_ddr_en;          /* DDR data phase */
+	uint8_t                 xip_rxds_en;         /* Read data strobe */
+	uint8_t                 xip_wrap_en;         /* WRAP cmd for wraps */
 };
 
 /**
@@ -90,12 +90,47 @@ struct ospi_init {
 
 	uint16_t  xip_wrap_cmd;			/* WRAP OpCode*/
 	uint16_t  xip_incr_cmd;			/* INCR mode OpCode*/
-	uint16_t  xip_cnt_time_out;		/* Timeout value*/
+	uint16_t  xip_cnt_time_out;		/* Timeout value, 0 for 100*/
 	uint16_t  xip_aes_rxds_dly;		/* AES RxDS Delay*/
 	uint16_t  xip_wait_cycles;		/* XiP Wait Cycle*/
 	uint16_t  xip_rxds_vl_en;		/* XiP RxDS variable latency*/
 };
 
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+struct device;
+
+/*---- OSPI DMA Configuration ---------------------*/
+struct ospi_dma_init {
+	const struct device *dma_dev;           /* DMA Controller */
+	uint32_t  tx_channel;                   /* Tx DMA Channel */
+	uint32_t  tx_request;                   /* Tx Peripheral Request */
+	uint32_t  rx_channel;                   /* Rx DMA Channel */
+	uint32_t  rx_request;                   /* Rx Peripheral Request */
+	uint32_t  group;                        /* Event Router DMA Group */
+};
+#endif
+
+/*---- OSPI XiP Profile ---------------------*/
+struct ospi_xip_profile {
+	bool      wrap;                 /* WRAP opcode for wrap bursts */
+	bool      prefetch;             /* Prefetch the next line */
+	bool      cont_xfer;            /* Keep CS low for sequential reads */
+	bool      ddr;                  /* DDR data phase */
+	bool      rxds;                 /* Sample with read data strobe */
+	uint16_t  cont_time_out;        /* Continuous timeout, 0 for init */
+};
+
+/**
+ * enum ospi_xip_profile_id
+ * Built-in XiP profiles
+ */
+enum ospi_xip_profile_id {
+	OSPI_XIP_PROFILE_DEFAULT = 0,   /* Init settings, scattered reads */
+	OSPI_XIP_PROFILE_STREAM,        /* Large sequential data reads */
+	OSPI_XIP_PROFILE_CODE,          /* Code execution, short runs */
+	OSPI_XIP_PROFILE_COUNT
+};
+
 /*---- OSPI Event ---------------------*/
 struct ospi_trans_config {
 	uint8_t  frame_size;            /* Data Frame Size [8, 16, 32] */
@@ -108,6 +143,24 @@ struct ospi_trans_config {
 	uint8_t  rx_ds_enable;          /* Read Data Strobe Enable */
 };
 
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+/*---- OSPI Queued Transaction ---------------------*/
+#define OSPI_XFER_READ                     0x0     /* Command, then receive */
+#define OSPI_XFER_WRITE                    0x1     /* Command, then transmit */
+
+struct ospi_xfer {
+	uint8_t   dir;                          /* OSPI_XFER_READ / WRITE */
+	uint8_t   cmd_cnt;                      /* Write only: command words */
+	uint8_t   seg_cnt;                      /* Data segments */
+	struct ospi_trans_config conf;          /* Frame setup for this one */
+	uint32_t  *cmd;                         /* Command and address words */
+	const struct ospi_segment *seg;         /* Data segments */
+	hal_event_notify_cb *done;              /* Completion, IRQ context */
+	void      *user_data;                   /* User data for done */
+	struct ospi_xfer *next;                 /* Internal, queue link */
+};
+#endif
+
 
 /**
  * \fn          alif_hal_ospi_initialize
@@ -172,6 +225,63 @@ int32_t alif_hal_ospi_transfer(HAL_OSPI_Handle_T handle,
 int32_t alif_hal_ospi_receive(HAL_OSPI_Handle_T handle,
 				void *data_out, int num);
 
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+/**
+ * \fn          alif_hal_ospi_dma_init
+ * \brief       Attach DMA channels to the instance and route their requests.
+ * \param[in]   handle  Instance handler
+ * \param[in]   dma_init  DMA controller, channels and requests
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_dma_init(HAL_OSPI_Handle_T handle,
+			const struct ospi_dma_init *dma_init);
+
+/**
+ * \fn          alif_hal_ospi_dma_send
+ * \brief       Transfer the data with DMA, completion is reported
+ *              through the event callback.
+ * \param[in]   handle  Instance handler
+ * \param[in]   data_out  Transmit data buffer, one 32-bit word per frame
+ * \param[in]   num  number of frames
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_dma_send(HAL_OSPI_Handle_T handle,
+			void *data_out, int num);
+
+/**
+ * \fn          alif_hal_ospi_dma_transfer
+ * \brief       Send command and receive data with DMA, completion is
+ *              reported through the event callback. Needs 16 or 32-bit
+ *              frames, 8-bit frames are only handled by
+ *              alif_hal_ospi_transfer.
+ * \param[in]   handle  Instance handler
+ * \param[in]   data_out  Command and address words
+ * \param[in]   data_in  Receive data buffer
+ * \param[in]   num  number of frames to receive
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_dma_transfer(HAL_OSPI_Handle_T handle,
+			void *data_out, void *data_in, int num);
+#endif
+
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+/**
+ * \fn          alif_hal_ospi_submit
+ * \brief       Queue a transaction. Transactions run back-to-back from the
+ *              completion interrupt, each with its own frame setup, which
+ *              stays in effect once the queue drains. A read sends the command
+ *              words the address length calls for, as
+ *              alif_hal_ospi_transfer() does; a write sends cmd_cnt words
+ *              and then the segments, one 32-bit word per frame. Each
+ *              transaction reports through its own done callback, not the
+ *              instance's event callback.
+ * \param[in]   handle  Instance handler
+ * \param[in]   xfer  Transaction, owned by the HAL until done is called
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_submit(HAL_OSPI_Handle_T handle, struct ospi_xfer *xfer);
+#endif
+
 /**
  * \fn          alif_hal_ospi_irq_handler
  * \brief       Interrupt Handler for OSPI interface.
@@ -198,6 +308,31 @@ int32_t alif_hal_ospi_xip_enable(HAL_OSPI_Handle_T handle);
 int32_t alif_hal_ospi_xip_disable(HAL_OSPI_Handle_T handle);
 
 
+/**
+ * \fn          alif_hal_ospi_xip_profile_set
+ * \brief       Apply XiP read settings. When XiP is enabled they take
+ *              effect at once, so the caller must not be executing from
+ *              or reading this device meanwhile. With wrap disabled the
+ *              INCR opcode also serves wrap bursts, only for devices
+ *              without wrapped reads behind masters that do not wrap.
+ * \param[in]   handle  Instance handler
+ * \param[in]   profile  XiP read settings
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_xip_profile_set(HAL_OSPI_Handle_T handle,
+				const struct ospi_xip_profile *profile);
+
+/**
+ * \fn          alif_hal_ospi_xip_profile_select
+ * \brief       Apply one of the built-in XiP profiles, see
+ *              alif_hal_ospi_xip_profile_set.
+ * \param[in]   handle  Instance handler
+ * \param[in]   id  Built-in profile
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_xip_profile_select(HAL_OSPI_Handle_T handle,
+				enum ospi_xip_profile_id id);
+
 /**
  * \fn          alif_hal_ospi_deinit
  * \brief       Release the initialized instance.
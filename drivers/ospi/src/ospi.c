@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
+
 #include "ospi.h"
 
 #define TX_INTR_MASK  (SPI_IMR_TX_FIFO_EMPTY_INTERRUPT_MASK		   \
@@ -14,6 +16,103 @@
 			| SPI_IMR_RX_FIFO_FULL_INTERRUPT_MASK		   \
 			| SPI_IMR_MULTI_MASTER_CONTENTION_INTERRUPT_MASK)  \
 
+/* Helper : Drain 32-bit frames carrying an 8-bit stream, first byte in MSB */
+static void ospi_rx_drain_packed(struct ospi_regs *ospi,
+				struct ospi_transfer *transfer,
+				uint32_t rx_count)
+{
+	uint8_t *dst = transfer->rx_buff;
+	uint32_t left, words, val, index;
+
+	if (transfer->rx_current_cnt >= transfer->rx_total_cnt)
+		return;
+
+	left = transfer->rx_packed_len - (transfer->rx_current_cnt * 4U);
+	words = left / 4U;
+	if (words > rx_count)
+		words = rx_count;
+
+	for (index = 0; index < words; index++) {
+		val = __builtin_bswap32(ospi->OSPI_DR0);
+		memcpy(dst, &val, sizeof(val));
+		dst += sizeof(val);
+	}
+	transfer->rx_current_cnt += words;
+
+	/* Tail: the last frame holds fewer than 4 wanted bytes */
+	if (words < rx_count &&
+		transfer->rx_current_cnt < transfer->rx_total_cnt) {
+		val = ospi->OSPI_DR0;
+		for (index = 0; index < (left & 3U); index++)
+			*dst++ = (uint8_t) (val >> (24U - (8U * index)));
+
+		transfer->rx_current_cnt++;
+	}
+
+	transfer->rx_buff = dst;
+}
+
+/* Helper : Account one frame, moving to the next segment when needed */
+static inline void *ospi_seg_frame(struct ospi_transfer *transfer,
+				void *buff)
+{
+	if (transfer->seg_left == 0) {
+		buff = transfer->seg->buff;
+		transfer->seg_left = transfer->seg->num;
+		transfer->seg++;
+	}
+	transfer->seg_left--;
+
+	return buff;
+}
+
+/* Helper : Drain the Rx FIFO into a segment list, frame by frame */
+static void ospi_rx_drain_seg(struct ospi_regs *ospi,
+				struct ospi_transfer *transfer,
+				uint32_t rx_count, uint32_t frame_size)
+{
+	uint8_t *dst = transfer->rx_buff;
+	uint32_t index, val, i;
+	/* 8-bit frames come in pairs, see ospi_irq_handler */
+	uint32_t per_entry = (frame_size > SPI_CTRLR0_DFS_8bit) ? 1U : 2U;
+
+	for (index = 0; index < rx_count; index++) {
+		val = ospi->OSPI_DR0;
+
+		for (i = 0; i < per_entry; i++) {
+			if (transfer->rx_current_cnt == transfer->rx_total_cnt)
+				break;
+
+			dst = ospi_seg_frame(transfer, dst);
+
+			if (frame_size > SPI_CTRLR0_DFS_16bit) {
+				memcpy(dst, &val, sizeof(uint32_t));
+				dst += sizeof(uint32_t);
+			} else if (frame_size > SPI_CTRLR0_DFS_8bit) {
+				*((uint16_t *) dst) = (uint16_t) val;
+				dst += sizeof(uint16_t);
+			} else {
+				*dst++ = (uint8_t) (val >> (8U - (8U * i)));
+			}
+			transfer->rx_current_cnt++;
+		}
+	}
+
+	transfer->rx_buff = dst;
+}
+
+/* Helper : Drop back to 8-bit frames after a packed read, ospi disabled */
+static void ospi_rx_packed_end(struct ospi_regs *ospi,
+				struct ospi_transfer *transfer)
+{
+	if (transfer->rx_packed_len == 0)
+		return;
+
+	ospi->OSPI_CTRLR0 = (ospi->OSPI_CTRLR0 & ~SPI_CTRLR0_DFS_MASK)
+				| SPI_CTRLR0_DFS_8bit;
+	transfer->rx_packed_len = 0;
+}
+
 /* Helper : update CTRL0 Reg with Frame Format and Transer mode bits */
 static uint32_t update_ctrl0_frf_tmode(uint32_t reg_val,
 					uint32_t frf,
@@ -61,7 +160,7 @@ static uint32_t set_ospi_ctrl0_in_xip(uint8_t frf,
 }
 
 /* Helper : value to ospi_xip_ctrl0 for XiP */
-static uint32_t set_xip_ctrl(uint8_t wait_cycles, uint8_t rxds_vl_en)
+static uint32_t set_xip_ctrl(struct ospi_xip_config *xfg)
 {
 	uint32_t val;
 
@@ -70,18 +169,18 @@ static uint32_t set_xip_ctrl(uint8_t wait_cycles, uint8_t rxds_vl_en)
 	| (XIP_CTRL_ADDR_LEN_36_BIT << XIP_CTRL_ADDR_L_OFFSET)
 	| (XIP_CTRL_INST_LEN_8_BIT << XIP_CTRL_INST_L_OFFSET)
 	| (0x0 << XIP_CTRL_MD_BITS_EN_OFFSET)
-	| (wait_cycles << XIP_CTRL_WAIT_CYCLES_OFFSET)
+	| (xfg->xip_wait_cycles << XIP_CTRL_WAIT_CYCLES_OFFSET)
 	| (0x1 << XIP_CTRL_DFS_HC_OFFSET)
-	| (0x1 << XIP_CTRL_DDR_EN_OFFSET)
+	| ((xfg->xip_ddr_en & 0x1) << XIP_CTRL_DDR_EN_OFFSET)
 	| (0x0 << XIP_CTRL_INST_DDR_EN_OFFSET)
-	| (0x1 << XIP_CTRL_RXDS_EN_OFFSET)
+	| ((xfg->xip_rxds_en & 0x1) << XIP_CTRL_RXDS_EN_OFFSET)
 	| (0x1 << XIP_CTRL_INST_EN_OFFSET)
-	| (0x0 << XIP_CTRL_CONT_XFER_EN_OFFSET)
+	| ((xfg->xip_cont_xfer_en & 0x1) << XIP_CTRL_CONT_XFER_EN_OFFSET)
 	| (0x0 << XIP_CTRL_XIP_HYPERBUS_EN_OFFSET)
 	| (0x0 << XIP_CTRL_RXDS_SIG_EN_OFFSET)
 	| (0x0 << XIP_CTRL_XIP_MBL_OFFSET)
-	| (0x0 << XIP_CTRL_XIP_PREFETCH_EN_OFFSET)
-	| (rxds_vl_en << XIP_CTRL_RXDS_VL_EN_OFFSET);
+	| ((xfg->xip_prefetch_en & 0x1) << XIP_CTRL_XIP_PREFETCH_EN_OFFSET)
+	| (xfg->xip_rxds_vl_en << XIP_CTRL_RXDS_VL_EN_OFFSET);
 
 	return val;
 }
@@ -366,6 +465,8 @@ void ospi_transfer(struct ospi_regs *ospi, struct ospi_transfer *transfer)
  */
 void ospi_dma_send(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 {
+	uint32_t start_lvl;
+
 	ospi_disable(ospi);
 
 	ospi->OSPI_CTRLR0 = update_ctrl0_frf_tmode(ospi->OSPI_CTRLR0,
@@ -379,8 +480,12 @@ void ospi_dma_send(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 
 	ospi->OSPI_TXFTLR &= ~(0xFFU << SPI_TXFTLR_TXFTHR_SHIFT);
 
-	ospi->OSPI_TXFTLR |=
-		((transfer->tx_total_cnt - 1U) << SPI_TXFTLR_TXFTHR_SHIFT);
+	/* Start once the FIFO is full, DMA keeps it topped up after that */
+	start_lvl = transfer->tx_total_cnt;
+	if (start_lvl > OSPI_TX_FIFO_DEPTH)
+		start_lvl = OSPI_TX_FIFO_DEPTH;
+
+	ospi->OSPI_TXFTLR |= ((start_lvl - 1U) << SPI_TXFTLR_TXFTHR_SHIFT);
 
 	ospi_enable_tx_dma(ospi);
 
@@ -490,6 +595,12 @@ void ospi_irq_handler(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 					tx_data = transfer->tx_default_val;
 				}
 			} else {
+				/* Command words first, then the data segments */
+				if (transfer->seg != NULL &&
+					transfer->mode == SPI_TMOD_TX)
+					transfer->tx_buff = ospi_seg_frame(transfer,
+						(void *) transfer->tx_buff);
+
 				tx_data = transfer->tx_buff[0];
 				transfer->tx_buff = (transfer->tx_buff + 1);
 			}
@@ -504,7 +615,11 @@ void ospi_irq_handler(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 
 		rx_count = ospi->OSPI_RXFLR;
 
-		if (frame_size > SPI_CTRLR0_DFS_16bit) {
+		if (transfer->rx_packed_len) {
+			ospi_rx_drain_packed(ospi, transfer, rx_count);
+		} else if (transfer->seg != NULL) {
+			ospi_rx_drain_seg(ospi, transfer, rx_count, frame_size);
+		} else if (frame_size > SPI_CTRLR0_DFS_16bit) {
 			for (index = 0; index < rx_count; index++) {
 				*((uint32_t *) transfer->rx_buff) =
 							ospi->OSPI_DR0;
@@ -525,33 +640,37 @@ void ospi_irq_handler(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 				transfer->rx_current_cnt++;
 			}
 		} else {
-			for (index = 0; index < rx_count; index++) {
-				/*
-				 * It is observed that with DFS set to 8,
-				 * the controller reads in 16bit frames.
-				 * Workaround this by making two valid
-				 * 8bit frames out of the DR content.
-				 */
+			/*
+			 * It is observed that with DFS set to 8,
+			 * the controller reads in 16bit frames.
+			 * Workaround this by making two valid
+			 * 8bit frames out of the DR content.
+			 */
+			uint8_t *dst = transfer->rx_buff;
+			uint32_t left = transfer->rx_total_cnt
+					- transfer->rx_current_cnt;
+			uint32_t pairs = left / 2U;
+
+			if (pairs > rx_count)
+				pairs = rx_count;
+
+			for (index = 0; index < pairs; index++) {
 				uint32_t val = ospi->OSPI_DR0;
 
-				*((uint8_t *) transfer->rx_buff) =
-					(uint8_t) ((val >> 8) & 0xff);
-				transfer->rx_buff =
-					(uint8_t *) transfer->rx_buff
-						+ sizeof(uint8_t);
-				transfer->rx_current_cnt++;
-
-				if (transfer->rx_current_cnt ==
-					transfer->rx_total_cnt)
-					break;
+				dst[0] = (uint8_t) (val >> 8);
+				dst[1] = (uint8_t) val;
+				dst += 2;
+			}
+			left -= pairs * 2U;
 
-				*((uint8_t *) transfer->rx_buff) =
-					(uint8_t) (val & 0xff);
-				transfer->rx_buff =
-					(uint8_t *) transfer->rx_buff
-						+ sizeof(uint8_t);
-				transfer->rx_current_cnt++;
+			/* Odd length: only the high byte of the last frame */
+			if (left && pairs < rx_count) {
+				*dst++ = (uint8_t) (ospi->OSPI_DR0 >> 8);
+				left--;
 			}
+
+			transfer->rx_buff = dst;
+			transfer->rx_current_cnt = transfer->rx_total_cnt - left;
 		}
 	}
 
@@ -559,6 +678,7 @@ void ospi_irq_handler(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 		(SPI_RX_FIFO_OVER_FLOW_EVENT | SPI_TX_FIFO_OVER_FLOW_EVENT)) {
 		/* Disabling and Enabling the OSPI will Reset the FIFO */
 		ospi_disable(ospi);
+		ospi_rx_packed_end(ospi, transfer);
 		ospi_enable(ospi);
 
 		transfer->status = SPI_TRANSFER_STATUS_OVERFLOW;
@@ -600,6 +720,7 @@ void ospi_irq_handler(struct ospi_regs *ospi, struct ospi_transfer *transfer)
 		ospi->OSPI_IMR = 0;
 
 		ospi_disable(ospi);
+		ospi_rx_packed_end(ospi, transfer);
 
 		transfer->rx_current_cnt = 0;
 		transfer->status = SPI_TRANSFER_STATUS_COMPLETE;
@@ -646,14 +767,18 @@ void ospi_xip_enable(struct ospi_regs *ospi, struct ospi_aes_regs *aes,
 					TMODE_RD_ONLY, SPI_CTRLR0_DFS_16bit);
 
 	/* Set OSPI XIP CTRL */
-	ospi->OSPI_XIP_CTRL = set_xip_ctrl(xfg->xip_wait_cycles,
-					xfg->xip_rxds_vl_en);
+	ospi->OSPI_XIP_CTRL = set_xip_ctrl(xfg);
 
 	ospi->OSPI_XIP_INCR_INST = xfg->incr_cmd;
-	ospi->OSPI_XIP_WRAP_INST = xfg->wrap_cmd;
+	/* Devices without wrapped reads get the INCR opcode for wraps too */
+	ospi->OSPI_XIP_WRAP_INST = xfg->xip_wrap_en ? xfg->wrap_cmd
+						   : xfg->incr_cmd;
 	ospi->OSPI_XIP_MODE_BITS = xfg->xip_mod_bits;
 	ospi->OSPI_RX_SAMPLE_DELAY = xfg->rx_smpl_dlay;
 
+	/* Cycles CS stays asserted waiting for the next sequential read */
+	ospi->OSPI_XIP_CNT_TIME_OUT = xfg->xip_cnt_time_out;
+
 #ifndef CONFIG_FLASH_ADDRESS_IN_SINGLE_FIFO_LOCATION
 	ospi_control_xip_ss(ospi, xfg->xip_cs_pin, SPI_SS_STATE_ENABLE);
 #endif
@@ -7,10 +7,40 @@
 
 #include "ospi_hal.h"
 
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+#include <zephyr/irq.h>
+#endif
+
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+#include <zephyr/cache.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/dma.h>
+#include "dma_event_router.h"
+
+/* Keep the Tx FIFO topped up, a Tx underflow ends the command early */
+#define HAL_OSPI_DMA_TX_LEVEL               (OSPI_TX_FIFO_DEPTH - 1)
+#define HAL_OSPI_DMA_RX_LEVEL               0
+
+enum hal_ospi_dma_state {
+	HAL_OSPI_DMA_IDLE,
+	HAL_OSPI_DMA_SEND,          /* Tx channel still feeding the FIFO */
+	HAL_OSPI_DMA_SEND_DRAIN,    /* Waiting for the FIFO to shift out */
+	HAL_OSPI_DMA_TRANSFER,      /* Waiting for the Rx channel */
+};
+#endif
+
 #define HAL_OSPI_MAX_INST                   2
 #define HAL_OSPI_INVALID_INST               -1
 #define HAL_OSPI_AES_RX_DS_DELAY_REG_OFFSET 0x20
 
+/* XiP continuous transfer timeout register is 8 bits wide */
+#define HAL_OSPI_XIP_CNT_TIME_OUT_MAX       0xFF
+/* Used when the init data leaves the timeout at 0 */
+#define HAL_OSPI_XIP_CNT_TIME_OUT_DEFAULT   100
+
+/* 8-bit reads from this length on are moved as 32-bit frames */
+#define HAL_OSPI_RX_PACKED_MIN_LEN          16
+
 /** OSPI_Instance */
 struct hal_ospi_inst {
 	int8_t   is_avail;
@@ -26,13 +56,49 @@ struct hal_ospi_inst {
 
 	/* Data Transfer */
 	struct ospi_transfer transfer;
+	/* Frame size from prepare_transfer, a packed read changes the live one */
+	uint8_t   frame_size;
 
 	/* XiP Config*/
 	struct ospi_xip_config   xip_config;
+	bool      xip_enabled;
+	/* Continuous timeout from init, restored by profiles without one */
+	uint16_t  xip_init_cnt_time_out;
 
 	/* Event Notifier */
 	hal_event_notify_cb *event_cb;
 	void  *user_data;
+
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+	/* DMA */
+	struct ospi_dma_init dma;
+	enum hal_ospi_dma_state dma_state;
+	void     *dma_rx_buff;
+	uint32_t  dma_rx_len;
+#endif
+
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+	/* Queued transactions, head is in the controller */
+	struct ospi_xfer *xfer_head;
+	struct ospi_xfer *xfer_tail;
+#endif
+};
+
+/* Built-in XiP profiles, indexed by enum ospi_xip_profile_id */
+static const struct ospi_xip_profile xip_profiles[OSPI_XIP_PROFILE_COUNT] = {
+	[OSPI_XIP_PROFILE_DEFAULT] = {
+		.wrap = true, .ddr = true, .rxds = true,
+	},
+	[OSPI_XIP_PROFILE_STREAM] = {
+		.wrap = true, .ddr = true, .rxds = true,
+		.prefetch = true, .cont_xfer = true,
+		.cont_time_out = HAL_OSPI_XIP_CNT_TIME_OUT_MAX,
+	},
+	[OSPI_XIP_PROFILE_CODE] = {
+		.wrap = true, .ddr = true, .rxds = true,
+		.prefetch = true, .cont_xfer = true,
+		.cont_time_out = 32,
+	},
 };
 
 /* Fixed Instances */
@@ -51,6 +117,254 @@ static struct hal_ospi_inst *get_inst_by_handle(HAL_OSPI_Handle_T handle)
 	return &(g_ospi_instance[handle]);
 }
 
+/* Helper : Command and address words pushed ahead of a read, 0 if unknown. */
+static uint32_t get_tx_cmd_cnt(uint32_t addr_len)
+{
+	switch (addr_len) {
+	case OSPI_ADDR_LENGTH_0_BITS:
+		return 1;
+	case OSPI_ADDR_LENGTH_24_BITS:
+		return 4;
+	case OSPI_ADDR_LENGTH_32_BITS:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+/* Helper : Take frame setup for the transfers that follow. */
+static void trans_config_apply(struct hal_ospi_inst *ospi_inst,
+			const struct ospi_trans_config *trans_conf)
+{
+	ospi_inst->frame_size = trans_conf->frame_size;
+	ospi_inst->transfer.addr_len = trans_conf->addr_len;
+	ospi_inst->transfer.dummy_cycle = trans_conf->wait_cycles;
+	ospi_inst->transfer.spi_frf = trans_conf->frame_format;
+	ospi_inst->transfer.ddr = trans_conf->ddr_enable;
+}
+
+/* Helper : Back to the configured frame size, no packed read pending. */
+static void transfer_reset(struct hal_ospi_inst *ospi_inst)
+{
+	struct ospi_regs *ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+
+	if (ospi_inst->frame_size != 0 &&
+		ospi_get_dfs(ospi_regs) != ospi_inst->frame_size)
+		ospi_set_dfs(ospi_regs, ospi_inst->frame_size);
+
+	ospi_inst->transfer.rx_packed_len = 0;
+}
+
+/* Helper : Controller or queue still owns the instance. */
+static bool inst_busy(struct hal_ospi_inst *ospi_inst)
+{
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+	if (ospi_inst->xfer_head != NULL)
+		return true;
+#endif
+	return ospi_busy((struct ospi_regs *) ospi_inst->regs);
+}
+
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+/* Helper : Load the head of the queue into the controller. */
+static void xfer_start(struct hal_ospi_inst *ospi_inst)
+{
+	struct ospi_xfer *xfer = ospi_inst->xfer_head;
+	struct ospi_transfer *transfer = &ospi_inst->transfer;
+	struct ospi_regs *ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+	uint32_t num = 0;
+	uint32_t i;
+
+	for (i = 0; i < xfer->seg_cnt; i++)
+		num += xfer->seg[i].num;
+
+	/* Chained commands may each need another frame setup */
+	trans_config_apply(ospi_inst, &xfer->conf);
+	transfer_reset(ospi_inst);
+
+	transfer->tx_buff        = xfer->cmd;
+	transfer->tx_current_cnt = 0;
+	transfer->rx_current_cnt = 0;
+	transfer->seg            = xfer->seg;
+	transfer->status         = SPI_TRANSFER_STATUS_NONE;
+
+	if (xfer->dir == OSPI_XFER_WRITE) {
+		/* Command words go out of tx_buff before the first segment */
+		transfer->tx_total_cnt = xfer->cmd_cnt + num;
+		transfer->seg_left     = xfer->cmd_cnt;
+		transfer->mode         = SPI_TMOD_TX;
+
+		ospi_send(ospi_regs, transfer);
+	} else {
+		transfer->tx_total_cnt = get_tx_cmd_cnt(transfer->addr_len);
+		transfer->rx_total_cnt = num;
+		transfer->rx_buff      = NULL;
+		transfer->seg_left     = 0;
+		transfer->mode         = SPI_TMOD_TX_AND_RX;
+
+		ospi_transfer(ospi_regs, transfer);
+	}
+}
+
+/* Helper : Retire the head and start the next one, IRQ context. */
+static void xfer_complete(struct hal_ospi_inst *ospi_inst, uint32_t event)
+{
+	struct ospi_xfer *xfer = ospi_inst->xfer_head;
+
+	ospi_inst->xfer_head = xfer->next;
+
+	if (ospi_inst->xfer_head == NULL) {
+		ospi_inst->xfer_tail = NULL;
+		ospi_inst->transfer.seg = NULL;
+	} else {
+		/* Back-to-back, before the owner even sees the completion */
+		xfer_start(ospi_inst);
+	}
+
+	xfer->done(event, xfer->user_data);
+}
+#endif /* CONFIG_ALIF_OSPI_HAL_QUEUE */
+
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+/* Helper : Stop the channels and take the controller out of DMA mode. */
+static void ospi_hal_dma_stop(struct hal_ospi_inst *ospi_inst)
+{
+	struct ospi_regs *ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+
+	ospi_regs->OSPI_IMR = 0;
+
+	ospi_disable_tx_dma(ospi_regs);
+	ospi_disable_rx_dma(ospi_regs);
+
+	dma_stop(ospi_inst->dma.dma_dev, ospi_inst->dma.tx_channel);
+	if (ospi_inst->dma_state == HAL_OSPI_DMA_TRANSFER)
+		dma_stop(ospi_inst->dma.dma_dev, ospi_inst->dma.rx_channel);
+
+	ospi_inst->dma_state = HAL_OSPI_DMA_IDLE;
+}
+
+/* Helper : DMA completion, runs in the DMA controller's interrupt. */
+static void ospi_hal_dma_cb(const struct device *dev, void *user_data,
+			uint32_t channel, int status)
+{
+	struct hal_ospi_inst *ospi_inst = user_data;
+	struct ospi_regs *ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+
+	if (status < 0) {
+		ospi_hal_dma_stop(ospi_inst);
+
+		ospi_inst->event_cb(OSPI_EVENT_DATA_LOST, ospi_inst->user_data);
+		return;
+	}
+
+	if (ospi_inst->dma_state == HAL_OSPI_DMA_SEND &&
+		channel == ospi_inst->dma.tx_channel) {
+		/*
+		 * Last word is in the FIFO, let the Tx empty interrupt
+		 * tell when it has been shifted out.
+		 */
+		ospi_disable_tx_dma(ospi_regs);
+		ospi_inst->dma_state = HAL_OSPI_DMA_SEND_DRAIN;
+		ospi_regs->OSPI_IMR |= SPI_IMR_TX_FIFO_EMPTY_INTERRUPT_MASK;
+
+	} else if (ospi_inst->dma_state == HAL_OSPI_DMA_TRANSFER &&
+		channel == ospi_inst->dma.rx_channel) {
+		ospi_hal_dma_stop(ospi_inst);
+		ospi_disable(ospi_regs);
+
+		sys_cache_data_invd_range(ospi_inst->dma_rx_buff,
+					ospi_inst->dma_rx_len);
+
+		ospi_inst->event_cb(OSPI_EVENT_TRANSFER_COMPLETE,
+						ospi_inst->user_data);
+	}
+}
+
+/* Helper : Program and start one channel between memory and the FIFO. */
+static int ospi_hal_dma_start(struct hal_ospi_inst *ospi_inst, bool tx,
+			void *buff, uint32_t len, uint32_t width)
+{
+	struct ospi_regs *ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+	struct dma_block_config block = {0};
+	struct dma_config cfg = {0};
+	uint32_t channel;
+	int ret;
+
+	block.block_size = len;
+
+	if (tx) {
+		block.source_address = (uint32_t) buff;
+		block.dest_address = (uint32_t) ospi_get_dma_addr(ospi_regs);
+		block.source_addr_adj = DMA_ADDR_ADJ_INCREMENT;
+		block.dest_addr_adj = DMA_ADDR_ADJ_NO_CHANGE;
+
+		cfg.channel_direction = MEMORY_TO_PERIPHERAL;
+		cfg.dma_slot = ospi_inst->dma.tx_request;
+		channel = ospi_inst->dma.tx_channel;
+	} else {
+		block.source_address = (uint32_t) ospi_get_dma_addr(ospi_regs);
+		block.dest_address = (uint32_t) buff;
+		block.source_addr_adj = DMA_ADDR_ADJ_NO_CHANGE;
+		block.dest_addr_adj = DMA_ADDR_ADJ_INCREMENT;
+
+		cfg.channel_direction = PERIPHERAL_TO_MEMORY;
+		cfg.dma_slot = ospi_inst->dma.rx_request;
+		channel = ospi_inst->dma.rx_channel;
+	}
+
+	cfg.source_data_size = width;
+	cfg.dest_data_size = width;
+	cfg.source_burst_length = 1;
+	cfg.dest_burst_length = 1;
+	cfg.block_count = 1;
+	cfg.head_block = &block;
+	cfg.dma_callback = ospi_hal_dma_cb;
+	cfg.user_data = ospi_inst;
+
+	ret = dma_config(ospi_inst->dma.dma_dev, channel, &cfg);
+	if (ret)
+		return ret;
+
+	return dma_start(ospi_inst->dma.dma_dev, channel);
+}
+
+/* Helper : OSPI interrupt while DMA owns the FIFOs. */
+static void ospi_hal_dma_irq(struct hal_ospi_inst *ospi_inst)
+{
+	struct ospi_regs *ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+	uint32_t event = ospi_regs->OSPI_ISR;
+	uint32_t notify = 0;
+
+	if (event & (SPI_RX_FIFO_OVER_FLOW_EVENT | SPI_TX_FIFO_OVER_FLOW_EVENT
+			| SPI_RX_FIFO_UNDER_FLOW_EVENT)) {
+		ospi_hal_dma_stop(ospi_inst);
+
+		/* Disabling and Enabling the OSPI will Reset the FIFO */
+		ospi_disable(ospi_regs);
+		ospi_enable(ospi_regs);
+
+		notify = OSPI_EVENT_DATA_LOST;
+
+	} else if (ospi_inst->dma_state == HAL_OSPI_DMA_SEND_DRAIN &&
+		(ospi_regs->OSPI_SR & (SPI_SR_BUSY | SPI_SR_TX_FIFO_EMPTY)) ==
+			SPI_SR_TX_FIFO_EMPTY) {
+		ospi_regs->OSPI_IMR = 0;
+		ospi_inst->dma_state = HAL_OSPI_DMA_IDLE;
+
+		notify = OSPI_EVENT_TRANSFER_COMPLETE;
+	}
+
+	/* Read interrupt clear registers */
+	(void) ospi_regs->OSPI_TXEICR;
+	(void) ospi_regs->OSPI_RXOICR;
+	(void) ospi_regs->OSPI_RXUICR;
+	(void) ospi_regs->OSPI_ICR;
+
+	if (notify)
+		ospi_inst->event_cb(notify, ospi_inst->user_data);
+}
+#endif /* CONFIG_ALIF_OSPI_HAL_DMA */
+
 /**
  * \fn          alif_hal_ospi_initialize
  * \brief       Get Instance and Initialized with given parameter
@@ -115,10 +429,16 @@ int32_t alif_hal_ospi_initialize(HAL_OSPI_Handle_T *handle,
 	ospi_inst->xip_config.wrap_cmd = init_d->xip_wrap_cmd;
 	ospi_inst->xip_config.incr_cmd = init_d->xip_incr_cmd;
 	ospi_inst->xip_config.xip_cs_pin = init_d->cs_pin;
-	ospi_inst->xip_config.xip_cnt_time_out = init_d->xip_cnt_time_out;
+	ospi_inst->xip_init_cnt_time_out = init_d->xip_cnt_time_out ?
+		init_d->xip_cnt_time_out : HAL_OSPI_XIP_CNT_TIME_OUT_DEFAULT;
+	ospi_inst->xip_config.xip_cnt_time_out = ospi_inst->xip_init_cnt_time_out;
 	ospi_inst->xip_config.aes_rx_ds_dlay = init_d->rx_ds_delay;
 	ospi_inst->xip_config.xip_rxds_vl_en = init_d->xip_rxds_vl_en;
 	ospi_inst->xip_config.xip_wait_cycles = init_d->xip_wait_cycles;
+	ospi_inst->xip_config.xip_wrap_en = 1;
+	ospi_inst->xip_config.xip_ddr_en = 1;
+	ospi_inst->xip_config.xip_rxds_en = 1;
+	ospi_inst->xip_enabled = false;
 
 	ospi_regs = (struct ospi_regs *) init_d->base_regs;
 
@@ -174,6 +494,19 @@ int32_t alif_hal_ospi_deinit(HAL_OSPI_Handle_T handle)
 	if (ospi_inst == NULL)
 		return OSPI_ERR_INVALID_HANDLE;
 
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+	if (ospi_inst->dma_state != HAL_OSPI_DMA_IDLE)
+		ospi_hal_dma_stop(ospi_inst);
+
+	memset(&ospi_inst->dma, 0, sizeof(struct ospi_dma_init));
+#endif
+
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+	/* Queued transactions are dropped without completion */
+	ospi_inst->xfer_head = NULL;
+	ospi_inst->xfer_tail = NULL;
+#endif
+
 	ospi_inst->is_avail = 1;
 
 	/* Clear rest. */
@@ -215,14 +548,13 @@ int32_t alif_hal_ospi_prepare_transfer(HAL_OSPI_Handle_T handle,
 	if (ospi_inst == NULL)
 		return OSPI_ERR_INVALID_HANDLE;
 
+	if (inst_busy(ospi_inst))
+		return OSPI_ERR_CTRL_BUSY;
+
 	ospi_regs = (struct ospi_regs *) ospi_inst->regs;
 
 	ospi_set_dfs(ospi_regs, trans_conf->frame_size);
-
-	ospi_inst->transfer.addr_len = trans_conf->addr_len;
-	ospi_inst->transfer.dummy_cycle = trans_conf->wait_cycles;
-	ospi_inst->transfer.spi_frf = trans_conf->frame_format;
-	ospi_inst->transfer.ddr = trans_conf->ddr_enable;
+	trans_config_apply(ospi_inst, trans_conf);
 
 	return  OSPI_ERR_NONE;
 }
@@ -242,7 +574,7 @@ int32_t alif_hal_ospi_cs_enable(HAL_OSPI_Handle_T handle, int enable)
 	if (ospi_inst == NULL)
 		return OSPI_ERR_INVALID_HANDLE;
 
-	if (ospi_busy((struct ospi_regs *) ospi_inst->regs))
+	if (inst_busy(ospi_inst))
 		return OSPI_ERR_CTRL_BUSY;
 
 	ospi_control_ss((struct ospi_regs *) ospi_inst->regs, ospi_inst->cs_pin,
@@ -270,14 +602,17 @@ int32_t alif_hal_ospi_send(HAL_OSPI_Handle_T handle, void *data, int num)
 	if (num <= 0)
 		return OSPI_ERR_INVALID_PARAM;
 
-	if (ospi_busy((struct ospi_regs *) ospi_inst->regs))
+	if (inst_busy(ospi_inst))
 		return OSPI_ERR_CTRL_BUSY;
 
+	transfer_reset(ospi_inst);
+
 	/* Update Transfer Settings */
 	ospi_inst->transfer.tx_total_cnt = num;
 	ospi_inst->transfer.mode = SPI_TMOD_TX;
 	ospi_inst->transfer.tx_buff = data;
 	ospi_inst->transfer.tx_current_cnt = 0;
+	ospi_inst->transfer.seg = NULL;
 	ospi_inst->transfer.status = SPI_TRANSFER_STATUS_NONE;
 
 	/* Send */
@@ -299,36 +634,289 @@ int32_t alif_hal_ospi_transfer(HAL_OSPI_Handle_T handle,
 			void *data_out, void *data_in, int num)
 {
 	struct hal_ospi_inst *ospi_inst;
+	struct ospi_regs *ospi_regs;
+	uint32_t tx_cnt;
 
 	ospi_inst = get_inst_by_handle(handle);
 	if (ospi_inst == NULL)
 		return OSPI_ERR_INVALID_HANDLE;
 
-	if (ospi_busy((struct ospi_regs *) ospi_inst->regs))
+	ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+
+	if (inst_busy(ospi_inst))
 		return OSPI_ERR_CTRL_BUSY;
 
-	ospi_inst->transfer.rx_total_cnt   = num;
+	transfer_reset(ospi_inst);
+
+	/*
+	 * Long 8-bit reads in the enhanced formats take 4 bytes per FIFO
+	 * entry instead of 2, the Rx handler restores byte order and the
+	 * 8-bit frame size at the end.
+	 */
+	if (num >= HAL_OSPI_RX_PACKED_MIN_LEN &&
+		ospi_inst->transfer.spi_frf != OSPI_FRF_STANDRAD &&
+		ospi_inst->frame_size == 8) {
+		ospi_set_dfs(ospi_regs, 32);
+		ospi_inst->transfer.rx_total_cnt = (num + 3) / 4;
+		ospi_inst->transfer.rx_packed_len = num;
+	} else {
+		ospi_inst->transfer.rx_total_cnt = num;
+	}
+
 	ospi_inst->transfer.mode           = SPI_TMOD_TX_AND_RX;
 
 	/* Tx total count based on address length */
-	if (ospi_inst->transfer.addr_len == OSPI_ADDR_LENGTH_0_BITS)
-		ospi_inst->transfer.tx_total_cnt = 1;
-	else if (ospi_inst->transfer.addr_len == OSPI_ADDR_LENGTH_24_BITS)
-		ospi_inst->transfer.tx_total_cnt = 4;
-	else if (ospi_inst->transfer.addr_len == OSPI_ADDR_LENGTH_32_BITS)
-		ospi_inst->transfer.tx_total_cnt = 2;
+	tx_cnt = get_tx_cmd_cnt(ospi_inst->transfer.addr_len);
+	if (tx_cnt)
+		ospi_inst->transfer.tx_total_cnt = tx_cnt;
+
+	ospi_inst->transfer.tx_buff        = data_out;
+	ospi_inst->transfer.rx_buff        = data_in;
+	ospi_inst->transfer.tx_current_cnt = 0;
+	ospi_inst->transfer.rx_current_cnt = 0;
+	ospi_inst->transfer.seg            = NULL;
+	ospi_inst->transfer.status         = SPI_TRANSFER_STATUS_NONE;
+
+	ospi_transfer(ospi_regs, &(ospi_inst->transfer));
+
+	return OSPI_ERR_NONE;
+}
+
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+/**
+ * \fn          alif_hal_ospi_dma_init
+ * \brief       Attach DMA channels to the instance and route their requests.
+ * \param[in]   handle  Instance handler
+ * \param[in]   dma_init  DMA controller, channels and requests
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_dma_init(HAL_OSPI_Handle_T handle,
+			const struct ospi_dma_init *dma_init)
+{
+	struct hal_ospi_inst *ospi_inst;
+
+	ospi_inst = get_inst_by_handle(handle);
+	if (ospi_inst == NULL)
+		return OSPI_ERR_INVALID_HANDLE;
+
+	if (dma_init == NULL || dma_init->dma_dev == NULL)
+		return OSPI_ERR_INVALID_PARAM;
+
+	if (!device_is_ready(dma_init->dma_dev))
+		return OSPI_ERR_INVALID_STATE;
+
+	if (dma_event_router_configure(dma_init->group, dma_init->tx_request) ||
+		dma_event_router_configure(dma_init->group, dma_init->rx_request))
+		return OSPI_ERR_INVALID_PARAM;
+
+	ospi_inst->dma = *dma_init;
+	ospi_inst->dma_state = HAL_OSPI_DMA_IDLE;
+
+	return OSPI_ERR_NONE;
+}
+
+/**
+ * \fn          alif_hal_ospi_dma_send
+ * \brief       Transfer the data with DMA, completion is reported
+ *              through the event callback.
+ * \param[in]   handle  Instance handler
+ * \param[in]   data_out  Transmit data buffer, one 32-bit word per frame
+ * \param[in]   num  number of frames
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_dma_send(HAL_OSPI_Handle_T handle, void *data, int num)
+{
+	struct hal_ospi_inst *ospi_inst;
+	struct ospi_regs *ospi_regs;
+	uint32_t len = num * sizeof(uint32_t);
+
+	ospi_inst = get_inst_by_handle(handle);
+	if (ospi_inst == NULL)
+		return OSPI_ERR_INVALID_HANDLE;
+
+	if (ospi_inst->dma.dma_dev == NULL)
+		return OSPI_ERR_INVALID_STATE;
+
+	if (num <= 0 || data == NULL)
+		return OSPI_ERR_INVALID_PARAM;
 
+	ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+
+	if (ospi_inst->dma_state != HAL_OSPI_DMA_IDLE || inst_busy(ospi_inst))
+		return OSPI_ERR_CTRL_BUSY;
+
+	transfer_reset(ospi_inst);
+
+	/* Update Transfer Settings */
+	ospi_inst->transfer.tx_total_cnt = num;
+	ospi_inst->transfer.mode = SPI_TMOD_TX;
+	ospi_inst->transfer.tx_buff = data;
+	ospi_inst->transfer.tx_current_cnt = 0;
+	ospi_inst->transfer.seg = NULL;
+	ospi_inst->transfer.status = SPI_TRANSFER_STATUS_NONE;
+
+	sys_cache_data_flush_range(data, len);
+
+	ospi_set_tx_dma_data_level(ospi_regs, HAL_OSPI_DMA_TX_LEVEL);
+
+	ospi_inst->dma_state = HAL_OSPI_DMA_SEND;
+
+	ospi_dma_send(ospi_regs, &ospi_inst->transfer);
+
+	if (ospi_hal_dma_start(ospi_inst, true, data, len, sizeof(uint32_t))) {
+		ospi_hal_dma_stop(ospi_inst);
+		ospi_disable(ospi_regs);
+		return OSPI_ERR_INVALID_STATE;
+	}
+
+	return OSPI_ERR_NONE;
+}
+
+/**
+ * \fn          alif_hal_ospi_dma_transfer
+ * \brief       Send command and receive data with DMA, completion is
+ *              reported through the event callback.
+ * \param[in]   handle  Instance handler
+ * \param[in]   data_out  Command and address words
+ * \param[in]   data_in  Receive data buffer
+ * \param[in]   num  number of frames to receive
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_dma_transfer(HAL_OSPI_Handle_T handle,
+			void *data_out, void *data_in, int num)
+{
+	struct hal_ospi_inst *ospi_inst;
+	struct ospi_regs *ospi_regs;
+	uint32_t tx_cnt, dfs, width;
+
+	ospi_inst = get_inst_by_handle(handle);
+	if (ospi_inst == NULL)
+		return OSPI_ERR_INVALID_HANDLE;
+
+	if (ospi_inst->dma.dma_dev == NULL)
+		return OSPI_ERR_INVALID_STATE;
+
+	if (num <= 0 || data_out == NULL || data_in == NULL)
+		return OSPI_ERR_INVALID_PARAM;
+
+	ospi_regs = (struct ospi_regs *) ospi_inst->regs;
+
+	tx_cnt = get_tx_cmd_cnt(ospi_inst->transfer.addr_len);
+	if (tx_cnt == 0)
+		return OSPI_ERR_INVALID_PARAM;
+
+	if (ospi_inst->dma_state != HAL_OSPI_DMA_IDLE || inst_busy(ospi_inst))
+		return OSPI_ERR_CTRL_BUSY;
+
+	transfer_reset(ospi_inst);
+
+	/* 8-bit frames arrive packed in pairs, only the IRQ path unpacks them */
+	dfs = ospi_get_dfs(ospi_regs);
+	if (dfs <= 8)
+		return OSPI_ERR_INVALID_PARAM;
+
+	width = (dfs > 16) ? sizeof(uint32_t) : sizeof(uint16_t);
+
+	ospi_inst->transfer.rx_total_cnt   = num;
+	ospi_inst->transfer.tx_total_cnt   = tx_cnt;
+	ospi_inst->transfer.mode           = SPI_TMOD_TX_AND_RX;
 	ospi_inst->transfer.tx_buff        = data_out;
 	ospi_inst->transfer.rx_buff        = data_in;
 	ospi_inst->transfer.tx_current_cnt = 0;
 	ospi_inst->transfer.rx_current_cnt = 0;
+	ospi_inst->transfer.seg            = NULL;
 	ospi_inst->transfer.status         = SPI_TRANSFER_STATUS_NONE;
 
-	ospi_transfer((struct ospi_regs *)ospi_inst->regs,
-			&(ospi_inst->transfer));
+	ospi_inst->dma_rx_buff = data_in;
+	ospi_inst->dma_rx_len = num * width;
+
+	sys_cache_data_flush_range(data_out, tx_cnt * sizeof(uint32_t));
+	/* No dirty line may be evicted on top of the DMA data */
+	sys_cache_data_flush_and_invd_range(data_in, ospi_inst->dma_rx_len);
+
+	ospi_set_tx_dma_data_level(ospi_regs, HAL_OSPI_DMA_TX_LEVEL);
+	ospi_set_rx_dma_data_level(ospi_regs, HAL_OSPI_DMA_RX_LEVEL);
+
+	ospi_inst->dma_state = HAL_OSPI_DMA_TRANSFER;
+
+	ospi_dma_transfer(ospi_regs, &ospi_inst->transfer);
+
+	/* Rx first, reception starts as soon as the command is in the FIFO */
+	if (ospi_hal_dma_start(ospi_inst, false, data_in,
+				ospi_inst->dma_rx_len, width) ||
+		ospi_hal_dma_start(ospi_inst, true, data_out,
+				tx_cnt * sizeof(uint32_t), sizeof(uint32_t))) {
+		ospi_hal_dma_stop(ospi_inst);
+		ospi_disable(ospi_regs);
+		return OSPI_ERR_INVALID_STATE;
+	}
+
+	return OSPI_ERR_NONE;
+}
+#endif /* CONFIG_ALIF_OSPI_HAL_DMA */
+
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+/**
+ * \fn          alif_hal_ospi_submit
+ * \brief       Queue a transaction, it starts right away when the
+ *              instance is idle, else from the completion interrupt of
+ *              the one before it.
+ * \param[in]   handle  Instance handler
+ * \param[in]   xfer  Transaction, owned by the HAL until done is called
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_submit(HAL_OSPI_Handle_T handle, struct ospi_xfer *xfer)
+{
+	struct hal_ospi_inst *ospi_inst;
+	unsigned int key;
+	uint32_t i;
+
+	ospi_inst = get_inst_by_handle(handle);
+	if (ospi_inst == NULL)
+		return OSPI_ERR_INVALID_HANDLE;
+
+	if (xfer == NULL || xfer->done == NULL || xfer->cmd == NULL ||
+		xfer->seg == NULL || xfer->seg_cnt == 0 ||
+		xfer->conf.frame_size == 0)
+		return OSPI_ERR_INVALID_PARAM;
+
+	for (i = 0; i < xfer->seg_cnt; i++) {
+		if (xfer->seg[i].buff == NULL || xfer->seg[i].num == 0)
+			return OSPI_ERR_INVALID_PARAM;
+	}
+
+	if (xfer->dir == OSPI_XFER_READ &&
+		get_tx_cmd_cnt(xfer->conf.addr_len) == 0)
+		return OSPI_ERR_INVALID_PARAM;
+
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+	if (ospi_inst->dma_state != HAL_OSPI_DMA_IDLE)
+		return OSPI_ERR_CTRL_BUSY;
+#endif
+
+	xfer->next = NULL;
+
+	key = irq_lock();
+
+	if (ospi_inst->xfer_head == NULL) {
+		if (ospi_busy((struct ospi_regs *) ospi_inst->regs)) {
+			irq_unlock(key);
+			return OSPI_ERR_CTRL_BUSY;
+		}
+
+		ospi_inst->xfer_head = xfer;
+		ospi_inst->xfer_tail = xfer;
+		xfer_start(ospi_inst);
+	} else {
+		ospi_inst->xfer_tail->next = xfer;
+		ospi_inst->xfer_tail = xfer;
+	}
+
+	irq_unlock(key);
 
 	return OSPI_ERR_NONE;
 }
+#endif /* CONFIG_ALIF_OSPI_HAL_QUEUE */
 
 /**
  * \fn          alif_hal_ospi_irq_handler
@@ -345,6 +933,13 @@ int32_t alif_hal_ospi_irq_handler(HAL_OSPI_Handle_T handle)
 
 	struct ospi_regs *ospi_reg = (struct ospi_regs *) ospi_inst->regs;
 
+#ifdef CONFIG_ALIF_OSPI_HAL_DMA
+	if (ospi_inst->dma_state != HAL_OSPI_DMA_IDLE) {
+		ospi_hal_dma_irq(ospi_inst);
+		return OSPI_ERR_NONE;
+	}
+#endif
+
 	ospi_inst->transfer.status = SPI_TRANSFER_STATUS_NONE;
 
 	ospi_irq_handler(ospi_reg, &ospi_inst->transfer);
@@ -353,6 +948,13 @@ int32_t alif_hal_ospi_irq_handler(HAL_OSPI_Handle_T handle)
 
 		ospi_inst->transfer.status = SPI_TRANSFER_STATUS_NONE;
 
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+		if (ospi_inst->xfer_head != NULL) {
+			xfer_complete(ospi_inst, OSPI_EVENT_TRANSFER_COMPLETE);
+			return OSPI_ERR_NONE;
+		}
+#endif
+
 		/* update event Status */
 		ospi_inst->event_cb(OSPI_EVENT_TRANSFER_COMPLETE,
 						ospi_inst->user_data);
@@ -363,6 +965,17 @@ int32_t alif_hal_ospi_irq_handler(HAL_OSPI_Handle_T handle)
 
 		ospi_inst->transfer.status = SPI_TRANSFER_STATUS_NONE;
 
+#ifdef CONFIG_ALIF_OSPI_HAL_QUEUE
+		if (ospi_inst->xfer_head != NULL) {
+			/* Abandon the broken transaction, go on with the rest */
+			ospi_reg->OSPI_IMR = 0;
+			ospi_disable(ospi_reg);
+
+			xfer_complete(ospi_inst, OSPI_EVENT_DATA_LOST);
+			return OSPI_ERR_NONE;
+		}
+#endif
+
 		/* update event Status */
 		ospi_inst->event_cb(OSPI_EVENT_DATA_LOST, ospi_inst->user_data);
 	}
@@ -410,9 +1023,63 @@ int32_t alif_hal_ospi_xip_enable(HAL_OSPI_Handle_T handle)
 	ospi_control_ss((struct ospi_regs *) ospi_inst->regs,
 			ospi_inst->cs_pin, SPI_SS_STATE_ENABLE);
 
+	ospi_inst->xip_enabled = true;
+
 	return OSPI_ERR_NONE;
 }
 
+/**
+ * \fn          alif_hal_ospi_xip_profile_set
+ * \brief       Apply XiP read settings, at once when XiP is enabled.
+ * \param[in]   handle  Instance handler
+ * \param[in]   profile  XiP read settings
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_xip_profile_set(HAL_OSPI_Handle_T handle,
+				const struct ospi_xip_profile *profile)
+{
+	struct hal_ospi_inst *ospi_inst;
+
+	ospi_inst = get_inst_by_handle(handle);
+	if (ospi_inst == NULL)
+		return OSPI_ERR_INVALID_HANDLE;
+
+	if (profile == NULL ||
+		profile->cont_time_out > HAL_OSPI_XIP_CNT_TIME_OUT_MAX)
+		return OSPI_ERR_INVALID_PARAM;
+
+	ospi_inst->xip_config.xip_wrap_en = profile->wrap;
+	ospi_inst->xip_config.xip_prefetch_en = profile->prefetch;
+	ospi_inst->xip_config.xip_cont_xfer_en = profile->cont_xfer;
+	ospi_inst->xip_config.xip_ddr_en = profile->ddr;
+	ospi_inst->xip_config.xip_rxds_en = profile->rxds;
+
+	/* Back to the init value when the profile leaves the timeout at 0 */
+	ospi_inst->xip_config.xip_cnt_time_out = profile->cont_time_out ?
+		profile->cont_time_out : ospi_inst->xip_init_cnt_time_out;
+
+	if (!ospi_inst->xip_enabled)
+		return OSPI_ERR_NONE;
+
+	return alif_hal_ospi_xip_enable(handle);
+}
+
+/**
+ * \fn          alif_hal_ospi_xip_profile_select
+ * \brief       Apply one of the built-in XiP profiles.
+ * \param[in]   handle  Instance handler
+ * \param[in]   id  Built-in profile
+ * \return      0 on Success, else error code.
+ */
+int32_t alif_hal_ospi_xip_profile_select(HAL_OSPI_Handle_T handle,
+				enum ospi_xip_profile_id id)
+{
+	if ((uint32_t) id >= OSPI_XIP_PROFILE_COUNT)
+		return OSPI_ERR_INVALID_PARAM;
+
+	return alif_hal_ospi_xip_profile_set(handle, &xip_profiles[id]);
+}
+
 /**
  * \fn          alif_hal_ospi_xip_disable
  * \brief       Disable XiP.
@@ -435,6 +1102,8 @@ int32_t alif_hal_ospi_xip_disable(HAL_OSPI_Handle_T handle)
 			(struct ospi_aes_regs *) ospi_inst->aes_regs,
 			&ospi_inst->transfer, &ospi_inst->xip_config);
 
+	ospi_inst->xip_enabled = false;
+
 	ospi_control_ss((struct ospi_regs *) ospi_inst->regs,
 			ospi_inst->cs_pin, SPI_SS_STATE_ENABLE);
 
@@ -110,6 +110,31 @@ struct alif_energy_detect_response {
 	int8_t max;
 };
 
+/**
+ * @brief Energy measurement sweep parameters
+ *
+ * channel_mask bit n selects channel n, only channels 11 to 26 are valid.
+ */
+struct alif_energy_detect_sweep {
+	uint32_t channel_mask;
+	uint8_t nb_tics;
+	int8_t threshold;
+};
+
+/**
+ * @brief Energy measurement sweep result callback
+ *
+ * Called in the caller's context once for each measured channel.
+ *
+ * @param[in]	channel		Measured channel
+ * @param[in]	status		Measurement status
+ * @param[in]	p_result	ED result, valid when status is ALIF_MAC154_STATUS_OK
+ * @param[in]	user_data	User data given to sweep
+ */
+typedef void (*alif_mac154_ed_sweep_cb)(uint8_t channel, enum alif_mac154_status_code status,
+					const struct alif_energy_detect_response *p_result,
+					void *user_data);
+
 /**
  * @brief CSL configuration parameters
  *
@@ -138,6 +163,36 @@ struct alif_mac154_csl_phase {
 	uint16_t csl_phase;
 };
 
+/**
+ * @brief Radio timestamp model state
+ *
+ */
+struct alif_mac154_timestamp_model_info {
+	int32_t drift_ppb;
+	uint32_t error_us;
+	uint32_t anchor_age_ms;
+	uint32_t local_count;
+	uint32_t query_count;
+	uint32_t event_count;
+	uint32_t event_corrections;
+	bool valid;
+};
+
+/**
+ * @brief Link layer command round-trip statistics
+ *
+ * Only commands the link layer answers at once are counted, transmit,
+ * energy detection and reset wait for the radio. Round-trip starts before
+ * the command is sent, so it includes the UART transfer. percentile_us is
+ * the 90th percentile round-trip time.
+ */
+struct alif_mac154_bus_latency_stats {
+	uint32_t count;
+	uint32_t avg_us;
+	uint32_t max_us;
+	uint32_t percentile_us;
+};
+
 /**
  * @brief Security Key description
  *
@@ -202,9 +257,47 @@ enum alif_mac154_status_code alif_mac154_version_get(uint8_t *p_major, uint8_t *
  * @return	Mac Hardware supported features
  */
 uint32_t alif_mac154_capabilities_get(void);
+
+/**
+ * @brief Get data rate of the bus between host and link layer.
+ *
+ * @return	Bus data rate in bits per second, 0 when the UART speed is unknown
+ */
+uint32_t alif_mac154_bus_speed_get(void);
+
+/**
+ * @brief Get measured link layer command round-trip latency.
+ *
+ * @return	90th percentile round-trip time in us of commands answered
+ *		at once, 0 before any command
+ */
+uint32_t alif_mac154_bus_latency_get(void);
+
+/**
+ * @brief Get link layer command round-trip statistics.
+ *
+ * @param[out]	p_stats			Round-trip statistics
+ */
+void alif_mac154_bus_latency_stats_get(struct alif_mac154_bus_latency_stats *p_stats);
+
+/**
+ * @brief Trace hook called after every link layer command round-trip.
+ *
+ * Default implementation is empty. Application may override it to feed
+ * a tracing backend. Called from the thread issuing the command.
+ *
+ * @param[in]	cmd_id			AHI message identifier of the command
+ * @param[in]	latency_us		Round-trip time, or wait limit on timeout
+ * @param[in]	status			ALIF_MAC154_STATUS_COMM_FAILURE on timeout
+ */
+void alif_mac154_cmd_trace(uint16_t cmd_id, uint32_t latency_us,
+			   enum alif_mac154_status_code status);
 /**
  * @brief Get current timestamp
  *
+ * With CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL successive timestamps never
+ * decrease, also when the model is re-anchored.
+ *
  * @param	p_timestamp		timestamp in us
  *
  * @return	ALIF_MAC154_STATUS_OK		Operation OK
@@ -213,6 +306,20 @@ uint32_t alif_mac154_capabilities_get(void);
  */
 enum alif_mac154_status_code alif_mac154_timestamp_get(uint64_t *p_timestamp);
 
+/**
+ * @brief Get local radio timestamp model state
+ *
+ * Reports radio clock drift relative to host clock, current error bound and
+ * how many timestamps were served locally.
+ *
+ * @param	p_info			Model state
+ *
+ * @return	ALIF_MAC154_STATUS_OK		Operation OK
+ *		ALIF_MAC154_STATUS_FAILED	Model not enabled
+ */
+enum alif_mac154_status_code
+alif_mac154_timestamp_model_get(struct alif_mac154_timestamp_model_info *p_info);
+
 /**
  * @brief Transmission of frame
  *
@@ -262,6 +369,25 @@ enum alif_mac154_status_code
 alif_mac154_energy_detection(struct alif_energy_detect *p_energy_detect,
 			     struct alif_energy_detect_response *p_energy_detect_result);
 
+/**
+ * @brief Energy detection measure over multiple channels
+ *
+ * Channels are measured back to back without releasing the API between
+ * them. Results are reported through callback as each channel completes.
+ *
+ * @param[in]	p_sweep		Channel mask and ED parameters, bits 11 to 26
+ * @param[in]	cb		Result callback
+ * @param[in]	user_data	User data passed to callback
+ *
+ * @return	ALIF_MAC154_STATUS_OK		All channels measured
+ *		ALIF_MAC154_STATUS_FAILED	Invalid parameters, or measurement failed
+ *						on some channel
+ *		ALIF_MAC154_STATUS_COMM_FAILURE	Module not connected
+ */
+enum alif_mac154_status_code
+alif_mac154_energy_detection_sweep(const struct alif_energy_detect_sweep *p_sweep,
+				   alif_mac154_ed_sweep_cb cb, void *user_data);
+
 /**
  * @brief Set device short address
  *
@@ -448,6 +574,20 @@ enum alif_mac154_status_code alif_mac154_security_frame_counter_set(uint32_t fra
 enum alif_mac154_status_code
 alif_mac154_security_frame_counter_set_if_larger(uint32_t frame_counter);
 
+/**
+ * @brief Get Security frame counter recovered from persistent storage
+ *
+ * Returned value is the first frame counter guaranteed unused before reset.
+ *
+ * @param[in]	key_index	Key description list index, or -1 for the global counter
+ * @param[out]	frame_counter	Recovered frame counter
+ *
+ * @return	ALIF_MAC154_STATUS_OK		Operation OK
+ *		ALIF_MAC154_STATUS_FAILED	Nothing stored or persistence disabled
+ */
+enum alif_mac154_status_code alif_mac154_security_frame_counter_restore(int key_index,
+									 uint32_t *frame_counter);
+
 /**
  * @brief Config Security key description list
  *
@@ -477,16 +617,35 @@ alif_mac154_tx_packet_parse(struct alif_802154_frame_parser *mac_frame);
  */
 enum alif_mac154_status_code
 alif_mac154_mac_data_encode_and_authenticate(struct alif_802154_frame_parser *mac_frame,
+					     uint8_t *mac64);
 
 /**
  * @brief Discover selected Information header data
  *
  * @return	True		IE element header is parsed and available
  *		False	IE element not exist
- */					     uint8_t *mac64);
+ */
 bool alif_mac154_ie_header_element_get(uint8_t *header_ptr, uint16_t length,
 				       struct mac_header_IE_s *header_ie);
 
+/**
+ * @brief Start iterating Header information elements
+ *
+ * Use gen_header.ie_header_offset and ie_info.ie_header_len of a parsed frame
+ * to iterate its header IEs without rescanning the field for each element.
+ */
+void alif_mac154_ie_header_iterator_init(struct alif_802154_ie_iterator *iter,
+					 uint8_t *header_ptr, uint16_t length);
+
+/**
+ * @brief Get next Header information element
+ *
+ * @return	True		IE element header is parsed and available
+ *		False	No more elements or element is malformed
+ */
+bool alif_mac154_ie_header_iterator_next(struct alif_802154_ie_iterator *iter,
+					 struct mac_header_IE_s *header_ie);
+
 /**
  * @brief get current CSL phase and timestamp when that was calculated.
  *
@@ -510,6 +669,20 @@ enum alif_mac154_status_code alif_mac154_ack_header_ie_set(uint16_t short_addres
 							   bool delete_ie,
 							   const struct alif_802154_header_ie *ie_info);
 
+/**
+ * @brief Program enhanced ACK IE elements again from host mirror.
+ * Called automatically after successful alif_mac154_reset(). Use after
+ * link layer has reported ALIF_MAC154_STATUS_RESET otherwise. Vendor
+ * specific IEs and IEs beyond the mirror size are not mirrored. Does
+ * nothing when CONFIG_IEEE802154_ALIF_ACK_IE_MIRROR_SIZE is 0.
+ *
+ * @return	ALIF_MAC154_STATUS_OK		Operation OK
+ *		ALIF_MAC154_STATUS_FAILED	Operation failed or some IEs were
+ *						not in the mirror
+ *		ALIF_MAC154_STATUS_COMM_FAILURE	Module not connected
+ */
+enum alif_mac154_status_code alif_mac154_ack_header_ie_replay(void);
+
 /**
  * @brief Get promiscuous mode configuration
  *
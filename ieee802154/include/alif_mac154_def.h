@@ -173,7 +173,8 @@ struct alif_802154_ccm_params {
 
 
 /**
- * Mac generic parsed frame information with address
+ * Mac generic parsed frame information with field offsets from frame start.
+ * Offset 0 is the frame control field so it marks a field not present.
  */
 struct alif_802154_header {
 	struct mac154_fcf fcf;
@@ -181,6 +182,18 @@ struct alif_802154_header {
 	uint8_t dst_addr_offset;
 	uint8_t src_pan_id_offset;
 	uint8_t src_addr_offset;
+	uint8_t sec_header_offset;
+	uint8_t ie_header_offset;
+	uint8_t ie_payload_offset;
+	uint8_t payload_offset;
+};
+
+/**
+ * Information element iterator, keeps scan position between calls
+ */
+struct alif_802154_ie_iterator {
+	uint8_t *ptr;
+	uint16_t remaining;
 };
 
 /* Frame parser */
@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/uart.h>
@@ -37,9 +38,58 @@ K_MUTEX_DEFINE(receive_mutex);
 /*AHI Protocol defines*/
 #define AHI_KE_MSG_TYPE 0x10
 
+#define AHI_UART_RX_CHUNK 16
+
+static int ahi_uart_reset(void);
+static int ahi_uart_send(const uint8_t *p_cmd, uint16_t cmd_length, const uint8_t *p_data,
+			 uint16_t data_length);
+
+static const struct alif_ahi_transport ahi_uart_transport = {
+	.reset = ahi_uart_reset,
+	.send = ahi_uart_send,
+};
+
+static const struct alif_ahi_transport *ahi_transport = &ahi_uart_transport;
+
+static void ahi_rx_byte(uint8_t byte)
+{
+	int status;
+
+	if (rx_msg.msg_len >= MAX_MSG_LEN) {
+		LOG_ERR("message too long");
+		rx_msg.msg_len = 0;
+	}
+	rx_msg.msg[rx_msg.msg_len++] = byte;
+
+	status = alif_ahi_msg_valid_message(&rx_msg);
+
+	if (status == 1) {
+		if (receive_cb) {
+			receive_cb(&rx_msg);
+		}
+		rx_msg.msg_len = 0;
+	} else if (status < 0) {
+		LOG_ERR("message corrupt %d", status);
+		/*Clean the buffer until it becomes empty or valid*/
+		while (rx_msg.msg_len && status < 0) {
+			memmove(rx_msg.msg, rx_msg.msg + 1, rx_msg.msg_len - 1);
+			rx_msg.msg_len--;
+			status = alif_ahi_msg_valid_message(&rx_msg);
+		}
+	}
+}
+
+void alif_ahi_rx_push(const uint8_t *p_data, uint16_t data_length)
+{
+	for (uint16_t i = 0; i < data_length; i++) {
+		ahi_rx_byte(p_data[i]);
+	}
+}
+
 void ahi_uart_callback(const struct device *dev, void *user_data)
 {
-	int read_bytes = 1;
+	uint8_t buf[AHI_UART_RX_CHUNK];
+	int read_bytes;
 
 	if (!uart_irq_update(uart_dev)) {
 		return;
@@ -51,55 +101,33 @@ void ahi_uart_callback(const struct device *dev, void *user_data)
 	if (!uart_irq_rx_ready(uart_dev)) {
 		return;
 	}
-	while (read_bytes > 0 && rx_msg.msg_len < MAX_MSG_LEN) {
-		read_bytes = uart_fifo_read(uart_dev, rx_msg.msg + rx_msg.msg_len, 1);
+
+	do {
+		read_bytes = uart_fifo_read(uart_dev, buf, sizeof(buf));
 		if (read_bytes < 0) {
 			LOG_ERR("read failed");
 			break;
 		}
-		rx_msg.msg_len += read_bytes;
-
-		int status = alif_ahi_msg_valid_message(&rx_msg);
-
-		if (status == 1) {
-			if (receive_cb) {
-				receive_cb(&rx_msg);
-			}
-			rx_msg.msg_len = 0;
-		} else if (status < 0) {
-			LOG_ERR("message corrupt %d", status);
-			/*Clean the buffer until it becomes empty or valid*/
-			while (rx_msg.msg_len && status < 0) {
-				memmove(rx_msg.msg, rx_msg.msg + 1, rx_msg.msg_len - 1);
-				rx_msg.msg_len--;
-				status = alif_ahi_msg_valid_message(&rx_msg);
-			}
-			read_bytes = 1;
-		}
-	}
+		alif_ahi_rx_push(buf, read_bytes);
+	} while (read_bytes == sizeof(buf));
 }
 
-int alif_ahi_msg_send(struct msg_buf *p_msg, const uint8_t *p_data, uint16_t data_length)
+static int ahi_uart_send(const uint8_t *p_cmd, uint16_t cmd_length, const uint8_t *p_data,
+			 uint16_t data_length)
 {
-	if (p_msg == NULL) {
-		return -1;
-	}
-
 	/* Deassert&assert rts_n, falling edge triggers wake up the RF core */
- 	wake_es0(uart_dev);
+	wake_es0(uart_dev);
 
-	for (int i = 0; i < p_msg->msg_len; i++) {
-		uart_poll_out(uart_dev, p_msg->msg[i]);
+	for (int i = 0; i < cmd_length; i++) {
+		uart_poll_out(uart_dev, p_cmd[i]);
 	}
-	if (p_data && data_length) {
-		for (int i = 0; i < data_length; i++) {
-			uart_poll_out(uart_dev, p_data[i]);
-		}
+	for (int i = 0; i < data_length; i++) {
+		uart_poll_out(uart_dev, p_data[i]);
 	}
 	return 0;
 }
 
-int alif_ahi_reset(void)
+static int ahi_uart_reset(void)
 {
 	if (!device_is_ready(uart_dev)) {
 		LOG_INF("UART device not found!");
@@ -109,9 +137,33 @@ int alif_ahi_reset(void)
 	uart_irq_callback_user_data_set(uart_dev, ahi_uart_callback, NULL);
 	uart_irq_rx_enable(uart_dev);
 	uart_irq_tx_enable(uart_dev);
+	return 0;
+}
+
+int alif_ahi_msg_send(struct msg_buf *p_msg, const uint8_t *p_data, uint16_t data_length)
+{
+	if (p_msg == NULL) {
+		return -1;
+	}
+
+	if (!p_data) {
+		data_length = 0;
+	}
+
+	return ahi_transport->send(p_msg->msg, p_msg->msg_len, p_data, data_length);
+}
+
+int alif_ahi_reset(void)
+{
 	/* Clear receive buffers */
 	rx_msg.msg_len = 0;
-	return 0;
+
+	return ahi_transport->reset();
+}
+
+void alif_ahi_transport_set(const struct alif_ahi_transport *transport)
+{
+	ahi_transport = transport ? transport : &ahi_uart_transport;
 }
 
 void alif_ahi_init(msg_received_callback callback)
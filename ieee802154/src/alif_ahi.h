@@ -20,6 +20,42 @@
  */
 typedef void (*msg_received_callback)(struct msg_buf *p_msg);
 
+/**
+ * @brief AHI transport
+ *
+ * Lower layer moving AHI messages between host and link layer. Received data
+ * is handed to alif_ahi_rx_push() which does the message framing.
+ */
+struct alif_ahi_transport {
+	/** Initialize transport and start receiving, called from alif_ahi_reset */
+	int (*reset)(void);
+	/** Send command buffer followed by optional appended data */
+	int (*send)(const uint8_t *p_cmd, uint16_t cmd_length, const uint8_t *p_data,
+		    uint16_t data_length);
+};
+
+/**
+ * @brief Select AHI transport
+ *
+ * Default is the UART selected with zephyr,ahi-uart chosen node. Transport
+ * can be replaced before the MAC API is initialized, for example with a
+ * link layer stand-in.
+ *
+ * @param[in]	transport	Transport to be used, NULL selects default
+ */
+void alif_ahi_transport_set(const struct alif_ahi_transport *transport);
+
+/**
+ * @brief Push data received from transport to AHI message framing
+ *
+ * Complete messages are passed to the receive callback. Called from the
+ * transport receive context, may be an ISR.
+ *
+ * @param[in]	p_data		Received data
+ * @param[in]	data_length	Length of the data
+ */
+void alif_ahi_rx_push(const uint8_t *p_data, uint16_t data_length);
+
 /**
  * @brief AHI message send
  *
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "alif_ahi_stats.h"
+
+/* First bucket upper bound is 1 << LATENCY_SHIFT us */
+#define LATENCY_SHIFT 6
+
+static struct k_spinlock stats_lock;
+static struct alif_ahi_cmd_stats cmd_stats[CONFIG_IEEE802154_ALIF_CMD_STATS_SIZE];
+static uint32_t cmd_overflow;
+static uint32_t error_count;
+
+static int latency_bucket(uint32_t latency_us)
+{
+	uint32_t scaled = latency_us >> LATENCY_SHIFT;
+	int bucket = 0;
+
+	while (scaled && bucket < ALIF_AHI_STATS_LATENCY_BUCKETS - 1) {
+		scaled >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+static struct alif_ahi_cmd_stats *cmd_stats_find(uint16_t cmd_id)
+{
+	for (int i = 0; i < ARRAY_SIZE(cmd_stats); i++) {
+		if (cmd_stats[i].count == 0) {
+			/* Slots are filled in order, first free ends the search */
+			cmd_stats[i].cmd_id = cmd_id;
+			cmd_stats[i].min_us = UINT32_MAX;
+			return &cmd_stats[i];
+		}
+		if (cmd_stats[i].cmd_id == cmd_id) {
+			return &cmd_stats[i];
+		}
+	}
+	return NULL;
+}
+
+void alif_ahi_stats_cmd_record(uint16_t cmd_id, uint32_t latency_us, bool timeout)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	struct alif_ahi_cmd_stats *p_stats = cmd_stats_find(cmd_id);
+
+	if (!p_stats) {
+		cmd_overflow++;
+		k_spin_unlock(&stats_lock, key);
+		return;
+	}
+
+	p_stats->count++;
+	if (timeout) {
+		/* Timeout latency is the wait limit, keep it out of the histogram */
+		p_stats->timeouts++;
+	} else {
+		p_stats->histogram[latency_bucket(latency_us)]++;
+		p_stats->sum_us += latency_us;
+		p_stats->min_us = MIN(p_stats->min_us, latency_us);
+		p_stats->max_us = MAX(p_stats->max_us, latency_us);
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void alif_ahi_stats_error_record(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	error_count++;
+	k_spin_unlock(&stats_lock, key);
+}
+
+int alif_ahi_stats_cmd_get(int index, struct alif_ahi_cmd_stats *p_stats)
+{
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	if (index < 0 || index >= ARRAY_SIZE(cmd_stats)) {
+		return -ENOENT;
+	}
+
+	key = k_spin_lock(&stats_lock);
+	if (cmd_stats[index].count == 0) {
+		ret = -ENOENT;
+	} else {
+		*p_stats = cmd_stats[index];
+	}
+	k_spin_unlock(&stats_lock, key);
+
+	return ret;
+}
+
+uint32_t alif_ahi_stats_error_count(void)
+{
+	return error_count;
+}
+
+void alif_ahi_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(cmd_stats, 0, sizeof(cmd_stats));
+	cmd_overflow = 0;
+	error_count = 0;
+	k_spin_unlock(&stats_lock, key);
+}
+
+#if defined(CONFIG_SHELL)
+static int cmd_stats_show(const struct shell *sh, size_t argc, char **argv)
+{
+	struct alif_ahi_cmd_stats stats;
+
+	shell_print(sh, "%-6s %8s %8s %8s %8s %8s  <64/128/256/512/1k/2k/4k/more us", "cmd",
+		    "count", "timeout", "min", "avg", "max");
+
+	for (int i = 0; alif_ahi_stats_cmd_get(i, &stats) == 0; i++) {
+		uint32_t ok = stats.count - stats.timeouts;
+
+		shell_print(sh, "0x%04x %8u %8u %8u %8u %8u  %u/%u/%u/%u/%u/%u/%u/%u",
+			    stats.cmd_id, stats.count, stats.timeouts, ok ? stats.min_us : 0,
+			    ok ? (uint32_t)(stats.sum_us / ok) : 0, stats.max_us,
+			    stats.histogram[0], stats.histogram[1], stats.histogram[2],
+			    stats.histogram[3], stats.histogram[4], stats.histogram[5],
+			    stats.histogram[6], stats.histogram[7]);
+	}
+
+	shell_print(sh, "error indications: %u", alif_ahi_stats_error_count());
+	if (cmd_overflow) {
+		shell_print(sh, "untracked commands: %u", cmd_overflow);
+	}
+	return 0;
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	alif_ahi_stats_reset();
+	shell_print(sh, "statistics cleared");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_alif_mac154_stats,
+			       SHELL_CMD(reset, NULL, "Clear statistics", cmd_stats_reset),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_alif_mac154,
+			       SHELL_CMD(stats, &sub_alif_mac154_stats,
+					 "Show AHI command statistics", cmd_stats_show),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(alif_mac154, &sub_alif_mac154, "Alif 802.15.4 link layer", NULL);
+#endif /* CONFIG_SHELL */
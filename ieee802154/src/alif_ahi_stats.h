@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IEEE802154_ALIF_AHI_STATS_H_
+#define IEEE802154_ALIF_AHI_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Log2 latency buckets, first bucket covers round-trips below 64us */
+#define ALIF_AHI_STATS_LATENCY_BUCKETS 8
+
+struct alif_ahi_cmd_stats {
+	uint16_t cmd_id;
+	uint32_t count;
+	uint32_t timeouts;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+	uint32_t histogram[ALIF_AHI_STATS_LATENCY_BUCKETS];
+};
+
+/**
+ * @brief Record one AHI command round-trip.
+ *
+ * @param[in]	cmd_id AHI message identifier of the command
+ * @param[in]	latency_us Time from command send start, UART transfer included,
+ *			to response or timeout
+ * @param[in]	timeout True when no response was received
+ */
+void alif_ahi_stats_cmd_record(uint16_t cmd_id, uint32_t latency_us, bool timeout);
+
+/**
+ * @brief Record an error indication received from the link layer.
+ */
+void alif_ahi_stats_error_record(void);
+
+/**
+ * @brief Get statistics of one command slot.
+ *
+ * @param[in]	index Slot index, starting from 0
+ * @param[out]	p_stats Copy of the slot
+ *
+ * @return	0 on success, -ENOENT when slot is not in use
+ */
+int alif_ahi_stats_cmd_get(int index, struct alif_ahi_cmd_stats *p_stats);
+
+/**
+ * @brief Get count of error indications received from the link layer.
+ *
+ * @return	Count of error indications
+ */
+uint32_t alif_ahi_stats_error_count(void);
+
+/**
+ * @brief Clear all statistics.
+ */
+void alif_ahi_stats_reset(void);
+
+#endif /* IEEE802154_ALIF_AHI_STATS_H_ */
@@ -6,8 +6,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/byteorder.h>
 
 #include "alif_mac154_api.h"
 
@@ -15,9 +18,14 @@
 
 #include "ahi_msg_lib.h"
 #include "alif_ahi.h"
+#include "alif_ahi_stats.h"
 #include "es0_power_manager.h"
 #include "alif_mac154_key_storage.h"
+#if defined(CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE)
+#include "alif_mac154_fc_store.h"
+#endif
 #include "alif_mac154_parser.h"
+#include "alif_mac154_timestamp.h"
 #include "alif_mac154_ccm_encode.h"
 
 #define LOG_MODULE_NAME alif_154_api
@@ -63,21 +71,68 @@ static K_SEM_DEFINE(ahi_receive_sem, 0, 1);
 
 static struct msg_buf *resp_msg_ptr;
 struct msg_buf ahi_msg;
+/* Host time of the last expected response, anchors the ACK timestamp */
+static uint64_t resp_host_time;
 
 /* API Callback functions */
 struct alif_mac154_api_cb api_cb;
 
+/* Command round-trip latency histogram */
+#define BUS_LATENCY_BUCKET_US 50
+#define BUS_LATENCY_BUCKETS   40
+/* Latency reported to upper layer covers this share of round-trips */
+#define BUS_LATENCY_PERCENTILE 90
+
+struct alif_hal_bus_latency {
+	uint32_t histogram[BUS_LATENCY_BUCKETS];
+	uint32_t count;
+	uint64_t sum_us;
+	uint32_t max_us;
+};
+
+static struct k_spinlock bus_latency_lock;
+static struct alif_hal_bus_latency bus_latency;
+/* Cycle count when the pending command was handed to the transport */
+static uint32_t cmd_start;
+
 /*Hardware capabilities*/
 static uint32_t ll_hw_version;
 static uint32_t ll_sw_version;
 static uint32_t hw_capabilities;
 
+/* O-QPSK 250 kbit/s */
+#define PHY_OCTET_US 32
+/* O-QPSK 2.4 GHz channels 11 to 26 */
+#define PHY_CHANNEL_MASK GENMASK(26, 11)
+
+/*
+ * Known delay from a frame timestamp to the host receiving its indication:
+ * PHR and PSDU airtime after the SFD, then the AHI message transfer.
+ */
+static uint32_t alif_hal_event_latency_us(uint8_t frame_len, uint16_t msg_len)
+{
+	uint32_t bus_speed = alif_mac154_bus_speed_get();
+	uint32_t latency_us = (1 + frame_len) * PHY_OCTET_US;
+
+	if (bus_speed) {
+		latency_us += (uint64_t)msg_len * 8 * 1000000 / bus_speed;
+	}
+
+	return latency_us;
+}
+
 void ahi_msg_received_callback(struct msg_buf *p_msg)
 {
 	struct alif_rx_frame_received frame;
+	uint64_t host_rx = 0;
+
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL)) {
+		host_rx = alif_mac154_ts_model_host_time();
+	}
 
 	if (alif_ahi_msg_resp_event_recv(resp_msg_ptr, p_msg)) {
 		resp_msg_ptr = NULL;
+		resp_host_time = host_rx;
 		k_sem_give(&ahi_receive_sem);
 		LOG_DBG("Excpected msg received");
 	} else if (api_cb.rx_frame_recv_cb && (ll_sw_version < VERSION(1, 1, 0)) &&
@@ -87,6 +142,11 @@ void ahi_msg_received_callback(struct msg_buf *p_msg)
 		frame.ack_frame_cnt = 0xDEADC0DE;
 		frame.ack_key_idx = 0xff;
 		frame.ack_sec = false;
+		if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL)) {
+			alif_mac154_ts_model_event_update(
+				frame.timestamp, host_rx,
+				alif_hal_event_latency_us(frame.len, p_msg->msg_len));
+		}
 		api_cb.rx_frame_recv_cb(&frame);
 		LOG_DBG("frame received");
 	} else if (api_cb.rx_frame_recv_cb && (ll_sw_version >= VERSION(1, 1, 0)) &&
@@ -94,13 +154,26 @@ void ahi_msg_received_callback(struct msg_buf *p_msg)
 						    &frame.frame_pending, &frame.timestamp,
 						    &frame.len, &frame.p_data, &frame.ack_sec,
 						    &frame.ack_frame_cnt, &frame.ack_key_idx)) {
+		if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL)) {
+			alif_mac154_ts_model_event_update(
+				frame.timestamp, host_rx,
+				alif_hal_event_latency_us(frame.len, p_msg->msg_len));
+		}
 		api_cb.rx_frame_recv_cb(&frame);
 		LOG_DBG("frame received");
-	} else if (api_cb.rx_status_cb && alif_ahi_msg_error_recv(p_msg, NULL, NULL)) {
-		api_cb.rx_status_cb(ALIF_MAC154_STATUS_OUT_OF_SYNC);
+	} else if (alif_ahi_msg_error_recv(p_msg, NULL, NULL)) {
+		if (IS_ENABLED(CONFIG_IEEE802154_ALIF_CMD_STATS)) {
+			alif_ahi_stats_error_record();
+		}
+		if (api_cb.rx_status_cb) {
+			api_cb.rx_status_cb(ALIF_MAC154_STATUS_OUT_OF_SYNC);
+		}
 		LOG_DBG("Error received");
 	} else if (api_cb.rx_status_cb && alif_ahi_msg_reset_recv(p_msg, NULL, NULL)) {
 		api_cb.rx_status_cb(ALIF_MAC154_STATUS_RESET);
+		if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL)) {
+			alif_mac154_ts_model_reset();
+		}
 		LOG_DBG("Reset received");
 	} else if (api_cb.rx_status_cb && (ll_sw_version >= VERSION(1, 1, 0)) &&
 		   alif_ahi_msg_rx_start_end_recv_1_1_0(p_msg, NULL, NULL)) {
@@ -117,14 +190,117 @@ void ahi_msg_received_callback(struct msg_buf *p_msg)
 	}
 }
 
-void alif_hal_msg_wait(struct msg_buf *p_msg_ptr)
+static void alif_hal_latency_record(uint32_t latency_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&bus_latency_lock);
+	uint32_t bucket = MIN(latency_us / BUS_LATENCY_BUCKET_US, BUS_LATENCY_BUCKETS - 1);
+
+	bus_latency.histogram[bucket]++;
+	bus_latency.count++;
+	bus_latency.sum_us += latency_us;
+	bus_latency.max_us = MAX(bus_latency.max_us, latency_us);
+
+	k_spin_unlock(&bus_latency_lock, key);
+}
+
+__weak void alif_mac154_cmd_trace(uint16_t cmd_id, uint32_t latency_us,
+				  enum alif_mac154_status_code status)
+{
+}
+
+/* Send a command, its round-trip includes the transfer to link layer */
+static int alif_hal_msg_send(struct msg_buf *p_msg_ptr)
+{
+	cmd_start = k_cycle_get_32();
+
+	return alif_ahi_msg_send(p_msg_ptr, NULL, 0);
+}
+
+/*
+ * bus_timing is false for commands answered only after a radio operation or
+ * link layer reset, their round-trip says nothing about the bus.
+ */
+static enum alif_mac154_status_code alif_hal_msg_wait_common(struct msg_buf *p_msg_ptr,
+							     bool bus_timing)
 {
+	/* Command is still in the buffer, response overwrites it */
+	uint16_t cmd_id = p_msg_ptr->msg_len >= 3 ? sys_get_le16(&p_msg_ptr->msg[1]) : 0;
+	enum alif_mac154_status_code status = ALIF_MAC154_STATUS_OK;
+	uint32_t latency_us;
+
 	resp_msg_ptr = p_msg_ptr;
 	p_msg_ptr->msg_len = 0;
 
 	if (k_sem_take(&ahi_receive_sem, K_MSEC(HAL_MSG_TIMEOUT_MS)) != 0) {
-		LOG_ERR("uart read timeout!, %u", p_msg_ptr->rsp_msg);
+		/* Late response must not complete the next command */
+		resp_msg_ptr = NULL;
+		k_sem_reset(&ahi_receive_sem);
+		LOG_ERR("uart read timeout!, cmd:%x rsp:%u", cmd_id, p_msg_ptr->rsp_msg);
+		status = ALIF_MAC154_STATUS_COMM_FAILURE;
+	}
+
+	latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - cmd_start);
+	if (status == ALIF_MAC154_STATUS_OK && bus_timing) {
+		alif_hal_latency_record(latency_us);
+	}
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_CMD_STATS)) {
+		alif_ahi_stats_cmd_record(cmd_id, latency_us,
+					  status != ALIF_MAC154_STATUS_OK);
 	}
+	alif_mac154_cmd_trace(cmd_id, latency_us, status);
+
+	return status;
+}
+
+enum alif_mac154_status_code alif_hal_msg_wait(struct msg_buf *p_msg_ptr)
+{
+	return alif_hal_msg_wait_common(p_msg_ptr, true);
+}
+
+/* Wait for a response that follows a radio operation or reset */
+static enum alif_mac154_status_code alif_hal_msg_wait_deferred(struct msg_buf *p_msg_ptr)
+{
+	return alif_hal_msg_wait_common(p_msg_ptr, false);
+}
+
+uint32_t alif_mac154_bus_speed_get(void)
+{
+	/* UART 8N1, 8 data bits out of 10 bit times */
+	return DT_PROP_OR(DT_CHOSEN(zephyr_ahi_uart), current_speed, 0) / 10 * 8;
+}
+
+void alif_mac154_bus_latency_stats_get(struct alif_mac154_bus_latency_stats *p_stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&bus_latency_lock);
+	uint32_t target = (bus_latency.count * BUS_LATENCY_PERCENTILE + 99) / 100;
+	uint32_t cumulative = 0;
+
+	p_stats->count = bus_latency.count;
+	p_stats->max_us = bus_latency.max_us;
+	p_stats->avg_us = bus_latency.count ? bus_latency.sum_us / bus_latency.count : 0;
+	p_stats->percentile_us = 0;
+
+	for (int i = 0; i < BUS_LATENCY_BUCKETS && bus_latency.count; i++) {
+		cumulative += bus_latency.histogram[i];
+		if (cumulative >= target) {
+			/* Upper edge of bucket, last bucket is open ended */
+			p_stats->percentile_us = (i == BUS_LATENCY_BUCKETS - 1)
+							 ? bus_latency.max_us
+							 : (i + 1) * BUS_LATENCY_BUCKET_US;
+			break;
+		}
+	}
+
+	k_spin_unlock(&bus_latency_lock, key);
+}
+
+uint32_t alif_mac154_bus_latency_get(void)
+{
+	struct alif_mac154_bus_latency_stats stats;
+
+	alif_mac154_bus_latency_stats_get(&stats);
+
+	return stats.percentile_us;
 }
 
 /*
@@ -154,14 +330,19 @@ enum alif_mac154_status_code alif_mac154_reset(void)
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_reset(&ahi_msg, 0);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait_deferred(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
 	if (ret != ALIF_MAC154_STATUS_OK) {
 		LOG_WRN("reset failed %x", ret);
+	} else {
+		/* Link layer lost its ACK IE table */
+		alif_mac154_ack_header_ie_replay();
 	}
 
 	return ret;
@@ -173,9 +354,11 @@ static enum alif_mac154_status_code alif_mac154_ll_version_get(uint32_t *p_hw_ve
 	enum alif_mac154_status_code ret;
 
 	alif_ahi_msg_version_get(&ahi_msg, 0);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_version(&ahi_msg, NULL, p_hw_version, p_sw_version);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_version(&ahi_msg, NULL, p_hw_version, p_sw_version);
+	}
 
 	if (ret != ALIF_MAC154_STATUS_OK) {
 		LOG_WRN("version get failed %x", ret);
@@ -200,6 +383,7 @@ enum alif_mac154_status_code alif_mac154_version_get(uint8_t *p_major, uint8_t *
 	LOG_INF("hw:%x, sw:%x", ll_hw_version, ll_sw_version);
 
 	if (ret != ALIF_MAC154_STATUS_OK) {
+		k_mutex_unlock(&api_mutex);
 		return ALIF_MAC154_STATUS_COMM_FAILURE;
 	}
 	if (ll_sw_version > MODULE_VERSION_INITIAL) {
@@ -231,15 +415,31 @@ uint32_t alif_mac154_capabilities_get(void)
 enum alif_mac154_status_code alif_mac154_timestamp_get(uint64_t *p_timestamp)
 {
 	enum alif_mac154_status_code ret;
+	uint64_t host_start = 0;
 
 	LOG_DBG("");
 
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL) &&
+	    alif_mac154_ts_model_get(p_timestamp)) {
+		return ALIF_MAC154_STATUS_OK;
+	}
+
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_timestamp_get(&ahi_msg, 0);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_timestamp(&ahi_msg, NULL, p_timestamp);
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL)) {
+		host_start = alif_mac154_ts_model_host_time();
+	}
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_timestamp(&ahi_msg, NULL, p_timestamp);
+	}
+
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL) && ret == ALIF_MAC154_STATUS_OK) {
+		alif_mac154_ts_model_query_update(host_start, alif_mac154_ts_model_host_time(),
+						  p_timestamp);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -249,6 +449,17 @@ enum alif_mac154_status_code alif_mac154_timestamp_get(uint64_t *p_timestamp)
 	return ret;
 }
 
+enum alif_mac154_status_code
+alif_mac154_timestamp_model_get(struct alif_mac154_timestamp_model_info *p_info)
+{
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL)) {
+		alif_mac154_ts_model_info_get(p_info);
+		return ALIF_MAC154_STATUS_OK;
+	}
+
+	return ALIF_MAC154_STATUS_FAILED;
+}
+
 enum alif_mac154_status_code alif_mac154_transmit(struct alif_tx_req *p_tx,
 						  struct alif_tx_ack_resp *p_tx_ack)
 {
@@ -262,10 +473,12 @@ enum alif_mac154_status_code alif_mac154_transmit(struct alif_tx_req *p_tx,
 	alif_ahi_msg_tx_start(&ahi_msg, p_tx->msg_id, p_tx->channel, p_tx->cca_requested,
 			      p_tx->acknowledgment_asked, p_tx->timestamp, p_tx->p_payload,
 			      p_tx->length);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait_deferred(&ahi_msg);
 
-	if (ll_sw_version >= VERSION(1, 1, 0)) {
+	if (ret != ALIF_MAC154_STATUS_OK) {
+		p_tx_ack->ack_msg_len = 0;
+	} else if (ll_sw_version >= VERSION(1, 1, 0)) {
 		ret = alif_ahi_msg_tx_start_resp_1_1_0(&ahi_msg, 0, &p_tx_ack->ack_rssi,
 						       &p_tx_ack->ack_timestamp, p_tx_ack->ack_msg,
 						       &p_tx_ack->ack_msg_len);
@@ -275,6 +488,13 @@ enum alif_mac154_status_code alif_mac154_transmit(struct alif_tx_req *p_tx,
 						 &p_tx_ack->ack_msg_len);
 	}
 
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL) && ret == ALIF_MAC154_STATUS_OK &&
+	    p_tx_ack->ack_msg_len) {
+		alif_mac154_ts_model_event_update(
+			p_tx_ack->ack_timestamp, resp_host_time,
+			alif_hal_event_latency_us(p_tx_ack->ack_msg_len, ahi_msg.msg_len));
+	}
+
 	k_mutex_unlock(&api_mutex);
 	return ret;
 }
@@ -288,9 +508,11 @@ enum alif_mac154_status_code alif_mac154_receive_start(struct alif_rx_enable *p_
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_rx_start(&ahi_msg, 0, p_rx->channel, false, p_rx->frames, p_rx->timestamp);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_rx_start_resp(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_rx_start_resp(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -309,9 +531,11 @@ enum alif_mac154_status_code alif_mac154_receive_stop(void)
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_rx_stop(&ahi_msg, 0);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -334,11 +558,14 @@ alif_mac154_energy_detection(struct alif_energy_detect *p_energy_measure,
 
 	alif_ahi_msg_ed_start(&ahi_msg, 0, p_energy_measure->channel, p_energy_measure->threshold,
 			      p_energy_measure->nb_tics, p_energy_measure->timestamp);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_energy_detect_resp(&ahi_msg, NULL, &p_energy_measure_result->nb_measure,
-					      &p_energy_measure_result->average,
-					      &p_energy_measure_result->max);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait_deferred(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_energy_detect_resp(&ahi_msg, NULL,
+						      &p_energy_measure_result->nb_measure,
+						      &p_energy_measure_result->average,
+						      &p_energy_measure_result->max);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -349,6 +576,54 @@ alif_mac154_energy_detection(struct alif_energy_detect *p_energy_measure,
 	return ret;
 }
 
+enum alif_mac154_status_code
+alif_mac154_energy_detection_sweep(const struct alif_energy_detect_sweep *p_sweep,
+				   alif_mac154_ed_sweep_cb cb, void *user_data)
+{
+	enum alif_mac154_status_code ret = ALIF_MAC154_STATUS_OK;
+	uint32_t channel_mask;
+
+	if (!p_sweep || (p_sweep->channel_mask & ~PHY_CHANNEL_MASK)) {
+		return ALIF_MAC154_STATUS_FAILED;
+	}
+	channel_mask = p_sweep->channel_mask;
+
+	LOG_DBG("mask:%x thr:%d", channel_mask, p_sweep->threshold);
+
+	k_mutex_lock(&api_mutex, K_FOREVER);
+
+	while (channel_mask) {
+		struct alif_energy_detect_response result = {0};
+		enum alif_mac154_status_code status;
+		uint8_t channel = find_lsb_set(channel_mask) - 1;
+
+		channel_mask &= ~BIT(channel);
+
+		alif_ahi_msg_ed_start(&ahi_msg, 0, channel, p_sweep->threshold, p_sweep->nb_tics,
+				      0);
+		alif_hal_msg_send(&ahi_msg);
+		status = alif_hal_msg_wait_deferred(&ahi_msg);
+		if (status == ALIF_MAC154_STATUS_OK) {
+			status = alif_ahi_msg_energy_detect_resp(&ahi_msg, NULL, &result.nb_measure,
+								 &result.average, &result.max);
+		}
+		if (status != ALIF_MAC154_STATUS_OK) {
+			LOG_WRN("energy detect ch:%d failed %x", channel, status);
+			if (ret == ALIF_MAC154_STATUS_OK) {
+				ret = status;
+			}
+		}
+
+		if (cb) {
+			cb(channel, status, &result, user_data);
+		}
+	}
+
+	k_mutex_unlock(&api_mutex);
+
+	return ret;
+}
+
 enum alif_mac154_status_code alif_mac154_short_address_set(uint16_t short_address)
 {
 	enum alif_mac154_status_code ret;
@@ -363,9 +638,11 @@ enum alif_mac154_status_code alif_mac154_short_address_set(uint16_t short_addres
 		alif_ahi_msg_short_id_set(&ahi_msg, 0, short_address);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -392,9 +669,11 @@ enum alif_mac154_status_code alif_mac154_extended_address_set(uint8_t *p_extende
 		alif_ahi_msg_long_id_set(&ahi_msg, 0, p_extended_address);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -418,9 +697,11 @@ enum alif_mac154_status_code alif_mac154_pan_id_set(uint16_t pan_id)
 		alif_ahi_msg_pan_id_set(&ahi_msg, 0, pan_id);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -444,9 +725,11 @@ enum alif_mac154_status_code alif_mac154_pendings_short_address_insert(uint16_t
 		alif_ahi_msg_pending_short_id_insert(&ahi_msg, 0, short_address);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -471,9 +754,11 @@ enum alif_mac154_status_code alif_mac154_pendings_short_address_remove(uint16_t
 		alif_ahi_msg_pending_short_id_remove(&ahi_msg, 0, short_address);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -504,9 +789,11 @@ enum alif_mac154_status_code alif_mac154_pendings_long_address_insert(uint8_t *p
 		alif_ahi_msg_pending_long_id_insert(&ahi_msg, 0, p_extended_address);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -538,9 +825,11 @@ enum alif_mac154_status_code alif_mac154_pendings_long_address_remove(uint8_t *p
 		alif_ahi_msg_pending_long_id_remove(&ahi_msg, 0, p_extended_address);
 	}
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -560,9 +849,11 @@ enum alif_mac154_status_code alif_mac154_promiscious_mode_set(bool promiscuous_m
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_promiscuous_set(&ahi_msg, 0, promiscuous_mode);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -582,9 +873,11 @@ enum alif_mac154_status_code alif_mac154_tx_power_set(int16_t dbm)
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_max_tx_power_set(&ahi_msg, 0, dbm);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -604,9 +897,11 @@ enum alif_mac154_status_code alif_mac154_cca_mode_set(enum alif_mac154_cca_mode
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_cca_mode_set(&ahi_msg, 0, mode);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -626,9 +921,11 @@ enum alif_mac154_status_code alif_mac154_ed_threshold_set(int8_t input)
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_ed_threshold_set(&ahi_msg, 0, input);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -649,9 +946,11 @@ enum alif_mac154_status_code alif_mac154_dbg_rf(uint8_t write, uint32_t key, uin
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_dbg_rf(&ahi_msg, 0, write, key, value);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_rf_dbg_resp(&ahi_msg, NULL, p_read);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_rf_dbg_resp(&ahi_msg, NULL, p_read);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -671,9 +970,11 @@ enum alif_mac154_status_code alif_mac154_csl_config_set(struct alif_mac154_csl_c
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_csl_period_set(&ahi_msg, 0, p_csl_config->csl_period);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_status(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -695,9 +996,11 @@ enum alif_mac154_status_code alif_mac154_rx_slot_set(struct alif_mac154_rx_slot
 
 	alif_ahi_msg_config_rx_slot(&ahi_msg, 0, p_rx_slot_config->start,
 				    p_rx_slot_config->duration, p_rx_slot_config->channel);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_config_rx_slot_resp(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_config_rx_slot_resp(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -715,9 +1018,11 @@ enum alif_mac154_status_code alif_mac154_expected_rx_time_set(uint32_t expected_
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_config_expected_rx_time(&ahi_msg, 0, expected_rx_time);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_set_expected_rx_time_resp(&ahi_msg, NULL);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_set_expected_rx_time_resp(&ahi_msg, NULL);
+	}
 
 	k_mutex_unlock(&api_mutex);
 	if (ret != ALIF_MAC154_STATUS_OK) {
@@ -736,9 +1041,11 @@ alif_mac154_key_value_description_set(struct alif_mac154_key_description *key_de
 
 	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TX_ENCRYPT)) {
 		alif_ahi_msg_clear_sec_keys(&ahi_msg, 0);
-		alif_ahi_msg_send(&ahi_msg, NULL, 0);
-		alif_hal_msg_wait(&ahi_msg);
-		ret = alif_ahi_msg_clear_key_desc_resp(&ahi_msg, NULL);
+		alif_hal_msg_send(&ahi_msg);
+		ret = alif_hal_msg_wait(&ahi_msg);
+		if (ret == ALIF_MAC154_STATUS_OK) {
+			ret = alif_ahi_msg_clear_key_desc_resp(&ahi_msg, NULL);
+		}
 		if (ret != ALIF_MAC154_STATUS_OK) {
 			LOG_WRN("Key descriotion clear failed %x", ret);
 		}
@@ -754,9 +1061,11 @@ alif_mac154_key_value_description_set(struct alif_mac154_key_description *key_de
 				key_desc_list->key_id_mode, key_desc_list->frame_counter,
 				key_desc_list->frame_counter_per_key);
 
-			alif_ahi_msg_send(&ahi_msg, NULL, 0);
-			alif_hal_msg_wait(&ahi_msg);
-			ret = alif_ahi_msg_set_key_desc_resp(&ahi_msg, NULL);
+			alif_hal_msg_send(&ahi_msg);
+			ret = alif_hal_msg_wait(&ahi_msg);
+			if (ret == ALIF_MAC154_STATUS_OK) {
+				ret = alif_ahi_msg_set_key_desc_resp(&ahi_msg, NULL);
+			}
 			if (ret != ALIF_MAC154_STATUS_OK) {
 				LOG_WRN("Key descriotion set failed %x", ret);
 				break;
@@ -809,6 +1118,27 @@ bool alif_mac154_ie_header_element_get(uint8_t *header_ptr, uint16_t length,
 	return false;
 }
 
+void alif_mac154_ie_header_iterator_init(struct alif_802154_ie_iterator *iter,
+					 uint8_t *header_ptr, uint16_t length)
+{
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TX_ENCRYPT)) {
+		alif_mac154_ie_iterator_init(iter, header_ptr, length);
+	} else {
+		iter->ptr = header_ptr;
+		iter->remaining = 0;
+	}
+}
+
+bool alif_mac154_ie_header_iterator_next(struct alif_802154_ie_iterator *iter,
+					 struct mac_header_IE_s *header_ie)
+{
+	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TX_ENCRYPT)) {
+		return alif_mac154_ie_header_next(iter, header_ie);
+	}
+
+	return false;
+}
+
 enum alif_mac154_status_code alif_mac154_security_frame_counter_set(uint32_t frame_counter)
 {
 	enum alif_mac154_status_code ret;
@@ -820,9 +1150,11 @@ enum alif_mac154_status_code alif_mac154_security_frame_counter_set(uint32_t fra
 
 	alif_ahi_msg_config_frame_counter(&ahi_msg, 0, frame_counter, false);
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_set_frame_counter_resp(&ahi_msg, NULL, false);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_set_frame_counter_resp(&ahi_msg, NULL, false);
+	}
 
 	k_mutex_unlock(&api_mutex);
 	if (ret != ALIF_MAC154_STATUS_OK) {
@@ -839,14 +1171,16 @@ alif_mac154_security_frame_counter_set_if_larger(uint32_t frame_counter)
 
 	k_mutex_lock(&api_mutex, K_FOREVER);
 	if (IS_ENABLED(CONFIG_IEEE802154_ALIF_TX_ENCRYPT)) {
-		alif_mac154_sec_frame_counter_set(frame_counter);
+		alif_mac154_sec_frame_counter_set_if_larger(frame_counter);
 	}
 
 	alif_ahi_msg_config_frame_counter(&ahi_msg, 0, frame_counter, true);
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_set_frame_counter_resp(&ahi_msg, NULL, true);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_set_frame_counter_resp(&ahi_msg, NULL, true);
+	}
 
 	k_mutex_unlock(&api_mutex);
 	if (ret != ALIF_MAC154_STATUS_OK) {
@@ -856,6 +1190,25 @@ alif_mac154_security_frame_counter_set_if_larger(uint32_t frame_counter)
 	return ret;
 }
 
+enum alif_mac154_status_code alif_mac154_security_frame_counter_restore(int key_index,
+									 uint32_t *frame_counter)
+{
+#if defined(CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE)
+	uint8_t slot = MAC_FC_STORE_SLOT_GLOBAL;
+
+	if (key_index >= MAC_KEY_STORAGE_SIZE) {
+		return ALIF_MAC154_STATUS_FAILED;
+	}
+	if (key_index >= 0) {
+		slot = key_index;
+	}
+	if (alif_mac154_fc_store_restore(slot, frame_counter)) {
+		return ALIF_MAC154_STATUS_OK;
+	}
+#endif
+	return ALIF_MAC154_STATUS_FAILED;
+}
+
 enum alif_mac154_status_code
 alif_mac154_csl_phase_get(struct alif_mac154_csl_phase *p_csl_phase_resp)
 {
@@ -866,10 +1219,12 @@ alif_mac154_csl_phase_get(struct alif_mac154_csl_phase *p_csl_phase_resp)
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	alif_ahi_msg_csl_phase_get(&ahi_msg, 0);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
-	ret = alif_ahi_msg_csl_phase_get_resp(&ahi_msg, NULL, &p_csl_phase_resp->timestamp,
-					      &p_csl_phase_resp->csl_phase);
+	alif_hal_msg_send(&ahi_msg);
+	ret = alif_hal_msg_wait(&ahi_msg);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = alif_ahi_msg_csl_phase_get_resp(&ahi_msg, NULL, &p_csl_phase_resp->timestamp,
+						      &p_csl_phase_resp->csl_phase);
+	}
 
 	k_mutex_unlock(&api_mutex);
 
@@ -889,8 +1244,10 @@ alif_mac154_ie_long_id_insert(const uint8_t *p_extended_address,
 
 	alif_ahi_msg_ie_header_gen(&ahi_msg, 0, 0, p_extended_address, ie_info);
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
+	alif_hal_msg_send(&ahi_msg);
+	if (alif_hal_msg_wait(&ahi_msg) != ALIF_MAC154_STATUS_OK) {
+		return ALIF_MAC154_STATUS_COMM_FAILURE;
+	}
 
 	return alif_ahi_msg_status(&ahi_msg, NULL);
 }
@@ -901,8 +1258,10 @@ alif_mac154_ie_short_id_insert(uint16_t short_address, const struct alif_802154_
 	LOG_DBG("0x%x", short_address);
 
 	alif_ahi_msg_ie_header_gen(&ahi_msg, 0, short_address, NULL, ie_info);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
+	alif_hal_msg_send(&ahi_msg);
+	if (alif_hal_msg_wait(&ahi_msg) != ALIF_MAC154_STATUS_OK) {
+		return ALIF_MAC154_STATUS_COMM_FAILURE;
+	}
 
 	return alif_ahi_msg_status(&ahi_msg, NULL);
 }
@@ -912,8 +1271,10 @@ static enum alif_mac154_status_code alif_mac154_ie_long_id_remove(const uint8_t
 	LOG_HEXDUMP_DBG(p_extended_address, 8, "long_id_remove addr:");
 	alif_ahi_msg_ie_header_gen(&ahi_msg, 0, 0, p_extended_address, NULL);
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
+	alif_hal_msg_send(&ahi_msg);
+	if (alif_hal_msg_wait(&ahi_msg) != ALIF_MAC154_STATUS_OK) {
+		return ALIF_MAC154_STATUS_COMM_FAILURE;
+	}
 
 	return alif_ahi_msg_status(&ahi_msg, NULL);
 }
@@ -924,8 +1285,10 @@ static enum alif_mac154_status_code alif_mac154_ie_short_id_remove(uint16_t shor
 
 	alif_ahi_msg_ie_header_gen(&ahi_msg, 0, short_address, NULL, NULL);
 
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
+	alif_hal_msg_send(&ahi_msg);
+	if (alif_hal_msg_wait(&ahi_msg) != ALIF_MAC154_STATUS_OK) {
+		return ALIF_MAC154_STATUS_COMM_FAILURE;
+	}
 
 	return alif_ahi_msg_status(&ahi_msg, NULL);
 }
@@ -934,39 +1297,217 @@ static enum alif_mac154_status_code alif_mac154_purge_all_ie(void)
 {
 
 	alif_ahi_msg_ie_purge_all(&ahi_msg, 0);
-	alif_ahi_msg_send(&ahi_msg, NULL, 0);
-	alif_hal_msg_wait(&ahi_msg);
+	alif_hal_msg_send(&ahi_msg);
+	if (alif_hal_msg_wait(&ahi_msg) != ALIF_MAC154_STATUS_OK) {
+		return ALIF_MAC154_STATUS_COMM_FAILURE;
+	}
 
 	return alif_ahi_msg_status(&ahi_msg, NULL);
 }
 
+/*
+ * Host mirror of Enhanced ACK header IEs programmed to link layer
+ */
+#define ACK_IE_MIRROR_SIZE CONFIG_IEEE802154_ALIF_ACK_IE_MIRROR_SIZE
+
+/* Header IE element IDs, IEEE 802.15.4-2020 table 7-7 */
+#define ACK_IE_ELEMENT_ID_VENDOR_SPECIFIC 0x00
+#define ACK_IE_ELEMENT_ID_CSL             0x1a
+#define ACK_IE_ELEMENT_ID_RENDEZVOUS_TIME 0x1d
+
+#if ACK_IE_MIRROR_SIZE > 0
+struct ack_ie_mirror_entry {
+	struct alif_802154_header_ie ie;
+	uint8_t extended_address[8];
+	uint16_t short_address;
+	bool extended;
+	bool used;
+};
+
+static struct ack_ie_mirror_entry ack_ie_mirror[ACK_IE_MIRROR_SIZE];
+/* Set when link layer may hold IEs not in mirror */
+static bool ack_ie_mirror_incomplete;
+
+static uint16_t ack_ie_element_id(const struct alif_802154_header_ie *ie)
+{
+	return (ie->element_id_high << 1) | ie->element_id_low;
+}
+
+/* Field by field, padding and unused union bytes are caller stack garbage */
+static bool ack_ie_equal(const struct alif_802154_header_ie *a,
+			 const struct alif_802154_header_ie *b)
+{
+	if (a->length != b->length || a->element_id_low != b->element_id_low ||
+	    a->element_id_high != b->element_id_high || a->type != b->type ||
+	    a->content_type != b->content_type) {
+		return false;
+	}
+
+	switch (ack_ie_element_id(a)) {
+	case ACK_IE_ELEMENT_ID_CSL:
+		return a->content.csl.csl_phase == b->content.csl.csl_phase &&
+		       a->content.csl.csl_period == b->content.csl.csl_period &&
+		       a->content.csl.csl_rendezvous_time == b->content.csl.csl_rendezvous_time &&
+		       a->content.csl.full_info == b->content.csl.full_info;
+	case ACK_IE_ELEMENT_ID_RENDEZVOUS_TIME:
+		return a->content.rendezvous_time.rendezvous_time ==
+			       b->content.rendezvous_time.rendezvous_time &&
+		       a->content.rendezvous_time.wakeup_interval ==
+			       b->content.rendezvous_time.wakeup_interval &&
+		       a->content.rendezvous_time.full_info == b->content.rendezvous_time.full_info;
+	default:
+		/* Content unknown to the mirror, always program it */
+		return false;
+	}
+}
+
+static struct ack_ie_mirror_entry *ack_ie_mirror_find(uint16_t short_address,
+						      const uint8_t *p_extended_address)
+{
+	for (int i = 0; i < ACK_IE_MIRROR_SIZE; i++) {
+		struct ack_ie_mirror_entry *entry = &ack_ie_mirror[i];
+
+		if (!entry->used || entry->extended != (p_extended_address != NULL)) {
+			continue;
+		}
+		if (p_extended_address) {
+			if (!memcmp(entry->extended_address, p_extended_address, 8)) {
+				return entry;
+			}
+		} else if (entry->short_address == short_address) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static bool ack_ie_mirror_match(uint16_t short_address, const uint8_t *p_extended_address,
+				const struct alif_802154_header_ie *ie_info)
+{
+	struct ack_ie_mirror_entry *entry = ack_ie_mirror_find(short_address, p_extended_address);
+
+	if (!ie_info) {
+		/* Removal is redundant only when mirror is known to be complete */
+		return !entry && !ack_ie_mirror_incomplete;
+	}
+
+	return entry && ack_ie_equal(&entry->ie, ie_info);
+}
+
+static void ack_ie_mirror_update(uint16_t short_address, const uint8_t *p_extended_address,
+				 const struct alif_802154_header_ie *ie_info)
+{
+	struct ack_ie_mirror_entry *entry = ack_ie_mirror_find(short_address, p_extended_address);
+
+	if (!ie_info || ack_ie_element_id(ie_info) == ACK_IE_ELEMENT_ID_VENDOR_SPECIFIC) {
+		if (entry) {
+			entry->used = false;
+		}
+		if (ie_info) {
+			/* Vendor payload points into caller buffer, cannot be replayed */
+			ack_ie_mirror_incomplete = true;
+		}
+		return;
+	}
+
+	for (int i = 0; !entry && i < ACK_IE_MIRROR_SIZE; i++) {
+		if (!ack_ie_mirror[i].used) {
+			entry = &ack_ie_mirror[i];
+		}
+	}
+	if (!entry) {
+		LOG_WRN("ACK IE mirror full");
+		ack_ie_mirror_incomplete = true;
+		return;
+	}
+
+	entry->used = true;
+	entry->extended = (p_extended_address != NULL);
+	entry->short_address = short_address;
+	if (p_extended_address) {
+		memcpy(entry->extended_address, p_extended_address, 8);
+	}
+	entry->ie = *ie_info;
+}
+
+static void ack_ie_mirror_clear(void)
+{
+	for (int i = 0; i < ACK_IE_MIRROR_SIZE; i++) {
+		ack_ie_mirror[i].used = false;
+	}
+	ack_ie_mirror_incomplete = false;
+}
+#else
+/* Mirror disabled: program every update, nothing to replay */
+static bool ack_ie_mirror_match(uint16_t short_address, const uint8_t *p_extended_address,
+				const struct alif_802154_header_ie *ie_info)
+{
+	return false;
+}
+
+static void ack_ie_mirror_update(uint16_t short_address, const uint8_t *p_extended_address,
+				 const struct alif_802154_header_ie *ie_info)
+{
+}
+
+static void ack_ie_mirror_clear(void)
+{
+}
+#endif /* ACK_IE_MIRROR_SIZE > 0 */
+
+static enum alif_mac154_status_code
+alif_mac154_ack_ie_program(uint16_t short_address, const uint8_t *p_extended_address,
+			   const struct alif_802154_header_ie *ie_info)
+{
+	enum alif_mac154_status_code ret;
+
+	if (ack_ie_mirror_match(short_address, p_extended_address, ie_info)) {
+		return ALIF_MAC154_STATUS_OK;
+	}
+
+	if (p_extended_address) {
+		ret = ie_info ? alif_mac154_ie_long_id_insert(p_extended_address, ie_info)
+			      : alif_mac154_ie_long_id_remove(p_extended_address);
+	} else {
+		ret = ie_info ? alif_mac154_ie_short_id_insert(short_address, ie_info)
+			      : alif_mac154_ie_short_id_remove(short_address);
+	}
+
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ack_ie_mirror_update(short_address, p_extended_address, ie_info);
+	}
+	return ret;
+}
+
 enum alif_mac154_status_code
 alif_mac154_ack_header_ie_set(uint16_t short_address, const uint8_t *p_extended_address,
 			      bool delete_all_ie, const struct alif_802154_header_ie *ie_info)
 {
 	enum alif_mac154_status_code ret;
+	enum alif_mac154_status_code ret_long;
 
 	LOG_DBG("");
 
 	k_mutex_lock(&api_mutex, K_FOREVER);
 
 	if (delete_all_ie) {
-		alif_mac154_purge_all_ie();
-		ret = ALIF_MAC154_STATUS_OK;
+		ret = alif_mac154_purge_all_ie();
+		if (ret == ALIF_MAC154_STATUS_OK) {
+			ack_ie_mirror_clear();
+		}
 		goto end;
 	}
 
-	if (!ie_info || ie_info->length == 0) {
+	if (ie_info && ie_info->length == 0) {
 		/*Delete IE headers for this device*/
-		alif_mac154_ie_short_id_remove(short_address);
-		alif_mac154_ie_long_id_remove(p_extended_address);
-		ret = ALIF_MAC154_STATUS_OK;
-		goto end;
+		ie_info = NULL;
 	}
 
-	/*Set the addresses*/
-	alif_mac154_ie_short_id_insert(short_address, ie_info);
-	alif_mac154_ie_long_id_insert(p_extended_address, ie_info);
+	ret = alif_mac154_ack_ie_program(short_address, NULL, ie_info);
+	ret_long = alif_mac154_ack_ie_program(0, p_extended_address, ie_info);
+	if (ret == ALIF_MAC154_STATUS_OK) {
+		ret = ret_long;
+	}
 
 end:
 	k_mutex_unlock(&api_mutex);
@@ -977,6 +1518,43 @@ end:
 	return ret;
 }
 
+enum alif_mac154_status_code alif_mac154_ack_header_ie_replay(void)
+{
+	enum alif_mac154_status_code ret = ALIF_MAC154_STATUS_OK;
+
+#if ACK_IE_MIRROR_SIZE > 0
+	k_mutex_lock(&api_mutex, K_FOREVER);
+
+	for (int i = 0; i < ACK_IE_MIRROR_SIZE; i++) {
+		struct ack_ie_mirror_entry *entry = &ack_ie_mirror[i];
+		enum alif_mac154_status_code status;
+
+		if (!entry->used) {
+			continue;
+		}
+
+		if (entry->extended) {
+			status = alif_mac154_ie_long_id_insert(entry->extended_address, &entry->ie);
+		} else {
+			status = alif_mac154_ie_short_id_insert(entry->short_address, &entry->ie);
+		}
+		if (status != ALIF_MAC154_STATUS_OK) {
+			LOG_WRN("ACK header IE replay failed %x", status);
+			ret = status;
+		}
+	}
+
+	if (ack_ie_mirror_incomplete && ret == ALIF_MAC154_STATUS_OK) {
+		LOG_WRN("ACK header IEs missing from mirror were not replayed");
+		ret = ALIF_MAC154_STATUS_FAILED;
+	}
+
+	k_mutex_unlock(&api_mutex);
+#endif
+
+	return ret;
+}
+
 bool alif_mac154_get_promiscuous_mode(void)
 {
 	return ALIF_MAC154_SHARED_PROMISCUOUS_MODE;
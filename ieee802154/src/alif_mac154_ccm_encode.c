@@ -35,11 +35,7 @@ int alif_mac154_ccm_encode_packet(struct alif_802154_frame_parser *mac_frame, ui
 		sec_frame_counter = sys_get_le32(ccm_params->sec_frame_counter);
 
 	} else {
-		if (key_info->frame_counter_per_key) {
-			sec_frame_counter = key_info->frame_counter++;
-		} else {
-			sec_frame_counter = alif_mac154_sec_frame_counter_get();
-		}
+		sec_frame_counter = alif_mac154_key_storage_frame_counter_reserve(key_info, 1);
 
 		sys_put_le32(sec_frame_counter, ccm_params->sec_frame_counter);
 		/* Copy mac Header and mark */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/crc.h>
+#include "mram_rw.h"
+#include "alif_mac154_fc_store.h"
+
+#define LOG_MODULE_NAME alif_154_fc_store
+
+#if defined(CONFIG_IEEE802154_DRIVER_LOG_LEVEL)
+#define LOG_LEVEL CONFIG_IEEE802154_DRIVER_LOG_LEVEL
+#else
+#define LOG_LEVEL LOG_LEVEL_INF
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#define FC_STORE_NODE    DT_NODELABEL(mac154_fc_partition)
+#define FC_STORE_ADDR    (DT_REG_ADDR(DT_MTD_FROM_FIXED_PARTITION(FC_STORE_NODE)) +               \
+			  DT_REG_ADDR(FC_STORE_NODE))
+#define FC_STORE_RECORDS (DT_REG_SIZE(FC_STORE_NODE) / sizeof(struct fc_record))
+
+/*
+ * Latest record of every active slot is kept within this many records from
+ * the journal head, so recovery never walks further back than that.
+ */
+#define FC_STORE_WINDOW (4 * MAC_FC_STORE_SLOTS)
+
+#define FC_RECORD_MAGIC 0xFC54
+
+/* Journal record, one MRAM write unit */
+struct fc_record {
+	uint32_t sequence;
+	uint32_t frame_counter;
+	uint8_t slot;
+	uint8_t reserved;
+	uint16_t magic;
+	uint32_t crc;
+};
+
+BUILD_ASSERT(sizeof(struct fc_record) == 16, "Journal record must be one MRAM write unit");
+BUILD_ASSERT((DT_REG_ADDR(FC_STORE_NODE) & 0xF) == 0, "Journal partition must be 16B aligned");
+BUILD_ASSERT(FC_STORE_RECORDS >= 2 * FC_STORE_WINDOW, "Journal partition too small");
+
+struct fc_slot {
+	/* Frame counters below limit are covered by journal */
+	atomic_t limit;
+	uint32_t sequence;
+	bool active;
+};
+
+static K_MUTEX_DEFINE(fc_store_mutex);
+static struct fc_slot fc_slots[MAC_FC_STORE_SLOTS];
+static uint32_t fc_next_sequence;
+
+static const volatile struct fc_record *fc_record_get(uint32_t index)
+{
+	return &((const volatile struct fc_record *)FC_STORE_ADDR)[index];
+}
+
+static uint32_t fc_record_crc(const struct fc_record *record)
+{
+	return crc32_ieee((const uint8_t *)record, offsetof(struct fc_record, crc));
+}
+
+static bool fc_record_read(uint32_t sequence, struct fc_record *record)
+{
+	*record = *(const struct fc_record *)fc_record_get(sequence % FC_STORE_RECORDS);
+
+	if (record->magic != FC_RECORD_MAGIC || record->crc != fc_record_crc(record)) {
+		return false;
+	}
+	if (record->slot >= MAC_FC_STORE_SLOTS) {
+		return false;
+	}
+
+	return record->sequence == sequence;
+}
+
+static int fc_record_write(uint8_t slot, uint32_t frame_counter)
+{
+	struct fc_record record = {
+		.sequence = fc_next_sequence,
+		.frame_counter = frame_counter,
+		.slot = slot,
+		.magic = FC_RECORD_MAGIC,
+	};
+	int ret;
+
+	record.crc = fc_record_crc(&record);
+
+	ret = write_16bytes((uint8_t *)fc_record_get(fc_next_sequence % FC_STORE_RECORDS),
+			    (uint8_t *)&record);
+	if (ret) {
+		LOG_ERR("journal write failed %d", ret);
+		return ret;
+	}
+
+	fc_slots[slot].sequence = fc_next_sequence++;
+	fc_slots[slot].active = true;
+	atomic_set(&fc_slots[slot].limit, (atomic_val_t)frame_counter);
+
+	return 0;
+}
+
+static void fc_store_commit(uint8_t slot, uint32_t frame_counter)
+{
+	if (fc_record_write(slot, frame_counter)) {
+		return;
+	}
+
+	/* Carry other slots forward before their records drop out of the window */
+	for (uint8_t i = 0; i < MAC_FC_STORE_SLOTS; i++) {
+		if (i == slot || !fc_slots[i].active) {
+			continue;
+		}
+		if (fc_next_sequence - fc_slots[i].sequence >
+		    FC_STORE_WINDOW - MAC_FC_STORE_SLOTS) {
+			fc_record_write(i, (uint32_t)atomic_get(&fc_slots[i].limit));
+		}
+	}
+}
+
+void alif_mac154_fc_store_update(uint8_t slot, uint32_t frame_counter_end)
+{
+	if (frame_counter_end <= (uint32_t)atomic_get(&fc_slots[slot].limit)) {
+		return;
+	}
+
+	k_mutex_lock(&fc_store_mutex, K_FOREVER);
+	if (frame_counter_end > (uint32_t)atomic_get(&fc_slots[slot].limit)) {
+		fc_store_commit(slot, frame_counter_end +
+					      CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE_INTERVAL);
+	}
+	k_mutex_unlock(&fc_store_mutex);
+}
+
+void alif_mac154_fc_store_set(uint8_t slot, uint32_t frame_counter)
+{
+	k_mutex_lock(&fc_store_mutex, K_FOREVER);
+	fc_store_commit(slot, frame_counter + CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE_INTERVAL);
+	k_mutex_unlock(&fc_store_mutex);
+}
+
+bool alif_mac154_fc_store_restore(uint8_t slot, uint32_t *frame_counter)
+{
+	*frame_counter = (uint32_t)atomic_get(&fc_slots[slot].limit);
+
+	return fc_slots[slot].active;
+}
+
+static int alif_mac154_fc_store_init(void)
+{
+	struct fc_record record;
+	uint32_t first_sequence;
+	uint32_t low, high;
+	int found = 0;
+
+	/*
+	 * Record at index i always carries a sequence number congruent to i, so
+	 * records written on the current lap form a prefix of the partition.
+	 * Binary search finds the end of that prefix.
+	 */
+	record = *(const struct fc_record *)fc_record_get(0);
+	if (!fc_record_read(record.sequence, &record) ||
+	    record.sequence % FC_STORE_RECORDS != 0) {
+		LOG_INF("empty journal");
+		return 0;
+	}
+	first_sequence = record.sequence;
+
+	low = 1;
+	high = FC_STORE_RECORDS;
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+
+		if (fc_record_read(first_sequence + mid, &record)) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	fc_next_sequence = first_sequence + low;
+
+	/* Walk back from head to find latest record of each slot */
+	for (uint32_t i = 1; i <= FC_STORE_WINDOW && i <= fc_next_sequence; i++) {
+		if (!fc_record_read(fc_next_sequence - i, &record)) {
+			break;
+		}
+		if (fc_slots[record.slot].active) {
+			continue;
+		}
+		fc_slots[record.slot].active = true;
+		fc_slots[record.slot].sequence = record.sequence;
+		atomic_set(&fc_slots[record.slot].limit, (atomic_val_t)record.frame_counter);
+		if (++found == MAC_FC_STORE_SLOTS) {
+			break;
+		}
+	}
+
+	if (fc_slots[MAC_FC_STORE_SLOT_GLOBAL].active) {
+		alif_mac154_sec_frame_counter_set_if_larger(
+			(uint32_t)atomic_get(&fc_slots[MAC_FC_STORE_SLOT_GLOBAL].limit));
+	}
+
+	LOG_INF("journal head %u, frame counter %u", fc_next_sequence,
+		(uint32_t)atomic_get(&fc_slots[MAC_FC_STORE_SLOT_GLOBAL].limit));
+
+	return 0;
+}
+
+SYS_INIT(alif_mac154_fc_store_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IEEE802154_ALIF_FC_STORE_H_
+#define IEEE802154_ALIF_FC_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alif_mac154_key_storage.h"
+
+/* Journal slot of the global frame counter, key slots use key storage index */
+#define MAC_FC_STORE_SLOT_GLOBAL MAC_KEY_STORAGE_SIZE
+#define MAC_FC_STORE_SLOTS       (MAC_KEY_STORAGE_SIZE + 1)
+
+/**
+ * @brief Make sure frame counters below given value are covered by the journal.
+ *
+ * Fast path is a single compare, a journal record is written only when the
+ * value passes the committed limit.
+ *
+ * @param[in]	slot Journal slot
+ * @param[in]	frame_counter_end First frame counter not yet used
+ */
+void alif_mac154_fc_store_update(uint8_t slot, uint32_t frame_counter_end);
+
+/**
+ * @brief Commit new frame counter base set by upper layer.
+ *
+ * @param[in]	slot Journal slot
+ * @param[in]	frame_counter Next frame counter to be used
+ */
+void alif_mac154_fc_store_set(uint8_t slot, uint32_t frame_counter);
+
+/**
+ * @brief Get frame counter recovered from the journal.
+ *
+ * @param[in]	slot Journal slot
+ * @param[out]	frame_counter First frame counter safe to use after reset
+ *
+ * @return	true when journal had a record for the slot
+ */
+bool alif_mac154_fc_store_restore(uint8_t slot, uint32_t *frame_counter);
+
+#endif /* IEEE802154_ALIF_FC_STORE_H_ */
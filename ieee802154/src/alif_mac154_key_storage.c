@@ -5,20 +5,110 @@
  */
 
 #include <string.h>
+#include <zephyr/toolchain.h>
 #include "alif_mac154_key_storage.h"
+#if defined(CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE)
+#include "alif_mac154_fc_store.h"
+#endif
+
+#define MAC_KEY_INDEX_EMPTY -1
+
+BUILD_ASSERT((MAC_KEY_INDEX_SIZE & (MAC_KEY_INDEX_SIZE - 1)) == 0,
+	     "Key index size must be power of two");
+BUILD_ASSERT(MAC_KEY_INDEX_SIZE >= 2 * MAC_KEY_STORAGE_SIZE, "Key index size too small");
 
 static struct alif_mac154_key_storage mac_sec_key_storage[MAC_KEY_STORAGE_SIZE];
-static int mac_sec_key_storage_size;
-static uint32_t mac_sec_frame_counter;
+static int8_t mac_sec_key_index[MAC_KEY_INDEX_SIZE];
+static atomic_t mac_sec_frame_counter;
+
+static inline void alif_mac154_frame_counter_persist(uint8_t slot, uint32_t frame_counter_end)
+{
+#if defined(CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE)
+	alif_mac154_fc_store_update(slot, frame_counter_end);
+#endif
+}
+
+static inline void alif_mac154_frame_counter_commit(uint8_t slot, uint32_t frame_counter)
+{
+#if defined(CONFIG_IEEE802154_ALIF_FRAME_COUNTER_STORE)
+	alif_mac154_fc_store_set(slot, frame_counter);
+#endif
+}
+
+static int alif_mac154_key_id_length(enum mac154_sec_keyid_mode key_id_mode)
+{
+	switch (key_id_mode) {
+	case MAC154_KEY_IDENTIFIER_MODE_1:
+		return 1;
+	case MAC154_KEY_IDENTIFIER_MODE_2:
+		return 5;
+	case MAC154_KEY_IDENTIFIER_MODE_3:
+		return 9;
+	default:
+		return 0;
+	}
+}
+
+static uint32_t alif_mac154_key_hash(enum mac154_sec_keyid_mode key_id_mode,
+				     const uint8_t *key_id, int length)
+{
+	/* FNV-1a, the key index is the last byte so it dominates the low bits */
+	uint32_t hash = 2166136261u ^ key_id_mode;
+
+	for (int i = 0; i < length; i++) {
+		hash = (hash ^ key_id[i]) * 16777619u;
+	}
+
+	return hash ^ (hash >> 16);
+}
 
 void alif_mac154_sec_frame_counter_set(uint32_t frame_counter)
 {
-	mac_sec_frame_counter = frame_counter;
+	atomic_set(&mac_sec_frame_counter, (atomic_val_t)frame_counter);
+	alif_mac154_frame_counter_commit(MAC_KEY_STORAGE_SIZE, frame_counter);
+}
+
+void alif_mac154_sec_frame_counter_set_if_larger(uint32_t frame_counter)
+{
+	atomic_val_t current;
+
+	do {
+		current = atomic_get(&mac_sec_frame_counter);
+		if ((uint32_t)current >= frame_counter) {
+			return;
+		}
+	} while (!atomic_cas(&mac_sec_frame_counter, current, (atomic_val_t)frame_counter));
+
+	alif_mac154_frame_counter_persist(MAC_KEY_STORAGE_SIZE, frame_counter);
 }
 
 uint32_t alif_mac154_sec_frame_counter_get(void)
 {
-	return mac_sec_frame_counter++;
+	return alif_mac154_sec_frame_counter_reserve(1);
+}
+
+uint32_t alif_mac154_sec_frame_counter_reserve(uint32_t count)
+{
+	uint32_t frame_counter = (uint32_t)atomic_add(&mac_sec_frame_counter, (atomic_val_t)count);
+
+	alif_mac154_frame_counter_persist(MAC_KEY_STORAGE_SIZE, frame_counter + count);
+
+	return frame_counter;
+}
+
+uint32_t alif_mac154_key_storage_frame_counter_reserve(struct alif_mac154_key_storage *key,
+						       uint32_t count)
+{
+	if (key->frame_counter_per_key) {
+		uint32_t frame_counter = (uint32_t)atomic_add(&key->frame_counter,
+							      (atomic_val_t)count);
+
+		alif_mac154_frame_counter_persist(key - mac_sec_key_storage, frame_counter + count);
+
+		return frame_counter;
+	}
+
+	return alif_mac154_sec_frame_counter_reserve(count);
 }
 
 int alif_mac154_key_storage_key_description_set(struct alif_mac154_key_description *key_desc_list,
@@ -28,18 +118,38 @@ int alif_mac154_key_storage_key_description_set(struct alif_mac154_key_descripti
 		return -1;
 	}
 
-	mac_sec_key_storage_size = list_size;
+	memset(mac_sec_key_index, MAC_KEY_INDEX_EMPTY, sizeof(mac_sec_key_index));
 
 	for (int i = 0; i < list_size; i++) {
+		int length;
+		uint32_t slot;
 
 		memcpy(mac_sec_key_storage[i].key_value, key_desc_list[i].key_value,
 		       MAC_SEC_KEY_SIZE);
 		memcpy(mac_sec_key_storage[i].key_id, key_desc_list[i].key_id,
 		       IEEE_MAC_KEY_SOURCE_MAX_SIZE);
-		mac_sec_key_storage[i].frame_counter = key_desc_list[i].frame_counter;
+		atomic_set(&mac_sec_key_storage[i].frame_counter,
+			   (atomic_val_t)key_desc_list[i].frame_counter);
 		mac_sec_key_storage[i].frame_counter_per_key =
 			key_desc_list[i].frame_counter_per_key;
 		mac_sec_key_storage[i].key_id_mode = key_desc_list[i].key_id_mode;
+		if (mac_sec_key_storage[i].frame_counter_per_key) {
+			alif_mac154_frame_counter_commit(i, key_desc_list[i].frame_counter);
+		}
+
+		length = alif_mac154_key_id_length(mac_sec_key_storage[i].key_id_mode);
+		if (!length) {
+			/* Not addressable by key identifier */
+			continue;
+		}
+
+		/* Open addressing with linear probing, index never fills up */
+		slot = alif_mac154_key_hash(mac_sec_key_storage[i].key_id_mode,
+					    mac_sec_key_storage[i].key_id, length);
+		while (mac_sec_key_index[slot & (MAC_KEY_INDEX_SIZE - 1)] != MAC_KEY_INDEX_EMPTY) {
+			slot++;
+		}
+		mac_sec_key_index[slot & (MAC_KEY_INDEX_SIZE - 1)] = i;
 	}
 
 	return 0;
@@ -48,30 +158,28 @@ int alif_mac154_key_storage_key_description_set(struct alif_mac154_key_descripti
 struct alif_mac154_key_storage *
 alif_mac154_key_storage_key_description_get(enum mac154_sec_keyid_mode key_id_mode, uint8_t *key_id)
 {
-	int length = 0;
+	int length = alif_mac154_key_id_length(key_id_mode);
+	uint32_t slot;
 
-	switch (key_id_mode) {
-	case MAC154_KEY_IDENTIFIER_MODE_1:
-		length = 1;
-		break;
-	case MAC154_KEY_IDENTIFIER_MODE_2:
-		length = 5;
-		break;
-	case MAC154_KEY_IDENTIFIER_MODE_3:
-		length = 9;
-		break;
-	default:
+	if (!length) {
 		return NULL;
 	}
 
-	for (int i = 0; i < mac_sec_key_storage_size; i++) {
-		if (mac_sec_key_storage[i].key_id_mode != key_id_mode) {
+	slot = alif_mac154_key_hash(key_id_mode, key_id, length);
+
+	for (int i = 0; i < MAC_KEY_INDEX_SIZE; i++, slot++) {
+		int8_t entry = mac_sec_key_index[slot & (MAC_KEY_INDEX_SIZE - 1)];
+
+		if (entry == MAC_KEY_INDEX_EMPTY) {
+			break;
+		}
+		if (mac_sec_key_storage[entry].key_id_mode != key_id_mode) {
 			continue;
 		}
-		if (memcmp(mac_sec_key_storage[i].key_id, key_id, length)) {
+		if (memcmp(mac_sec_key_storage[entry].key_id, key_id, length)) {
 			continue;
 		}
-		return &mac_sec_key_storage[i];
+		return &mac_sec_key_storage[entry];
 	}
 
 	return NULL;
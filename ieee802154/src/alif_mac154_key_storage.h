@@ -7,6 +7,7 @@
 #ifndef IEEE802154_ALIF_KEY_STORAGE_H_
 #define IEEE802154_ALIF_KEY_STORAGE_H_
 
+#include <zephyr/sys/atomic.h>
 #include "alif_mac154_api.h"
 #include "alif_mac154_def.h"
 
@@ -14,23 +15,26 @@
 #define IEEE_MAC_KEY_SOURCE_MAX_SIZE 9
 #define MAC_SEC_KEY_SIZE             16
 
+/* Lookup index size, power of two and at least twice the storage size */
+#define MAC_KEY_INDEX_SIZE 8
+
 /* Key storage information */
 struct alif_mac154_key_storage {
 	uint8_t key_value[MAC_SEC_KEY_SIZE];
 	uint8_t key_id[IEEE_MAC_KEY_SOURCE_MAX_SIZE];
-	uint32_t frame_counter;
+	atomic_t frame_counter;
 	enum mac154_sec_keyid_mode key_id_mode;
 	bool frame_counter_per_key;
 };
 
 /**
- * @brief Get security enabled bit value from Frame control field.
+ * @brief Set key descriptions to storage and rebuild lookup index.
  *
  * @param[in]	key_desc_list Pointer to key description list
  * @param[in]	list_size list size
  *
  * @return	0 key set OK.
- * @return	False Frame security and authentication is disabled.
+ * @return	-1 list does not fit to storage.
  */
 int alif_mac154_key_storage_key_description_set(struct alif_mac154_key_description *key_desc_list,
 						int list_size);
@@ -47,6 +51,20 @@ struct alif_mac154_key_storage *
 alif_mac154_key_storage_key_description_get(enum mac154_sec_keyid_mode key_id_mode,
 					    uint8_t *key_id);
 
+/**
+ * @brief Reserve consecutive frame counters for a key.
+ *
+ * Uses the key's own counter when it is configured per key, otherwise the
+ * global security frame counter.
+ *
+ * @param[in]	key Key description from storage
+ * @param[in]	count Number of counters to reserve
+ *
+ * @return	First reserved frame counter
+ */
+uint32_t alif_mac154_key_storage_frame_counter_reserve(struct alif_mac154_key_storage *key,
+						       uint32_t count);
+
 /**
  * @brief Set global used security frame counter.
  *
@@ -56,13 +74,32 @@ alif_mac154_key_storage_key_description_get(enum mac154_sec_keyid_mode key_id_mo
 void alif_mac154_sec_frame_counter_set(uint32_t frame_counter);
 
 /**
- * @brief Get and increment global security frame counter.
+ * @brief Set global used security frame counter if it is larger than current one.
  *
  * @param[in]	frame_counter Frame counter
  *
+ */
+void alif_mac154_sec_frame_counter_set_if_larger(uint32_t frame_counter);
+
+/**
+ * @brief Get and increment global security frame counter.
+ *
  * @return 	Frame counter
  *
  */
 uint32_t alif_mac154_sec_frame_counter_get(void);
 
+/**
+ * @brief Reserve consecutive global security frame counters.
+ *
+ * Reservation is atomic so frames queued from different threads never
+ * share a counter value.
+ *
+ * @param[in]	count Number of counters to reserve
+ *
+ * @return 	First reserved frame counter
+ *
+ */
+uint32_t alif_mac154_sec_frame_counter_reserve(uint32_t count);
+
 #endif /* IEEE802154_ALIF_KEY_STORAGE_H_ */
@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <zephyr/sys/byteorder.h>
 #include "alif_mac154_parser.h"
 
@@ -107,297 +108,251 @@ static bool mac_parse_payload_ie(struct mac_payload_IE_s *payload_element, uint8
 	return true;
 }
 
-static bool alif_mac154_header_ie_parse(struct alif_802154_frame_parser *mac_frame)
+static int mac_address_length(enum mac154_address_mode address_mode)
 {
+	switch (address_mode) {
+	case MAC154_ADDRESSING_MODE_NOT_PRESENT:
+		return 0;
+	case MAC154_ADDRESSING_MODE_SHORT:
+		return 2;
+	case MAC154_ADDRESSING_MODE_EXTENDED:
+		return 8;
+	default:
+	}
+	return -1;
+}
 
-	struct mac_header_IE_s header_ie;
-	uint8_t *ptr = mac_frame->mac_payload;
-	struct alif_802154_ie_params *ie_params = &mac_frame->ie_info;
+void alif_mac154_ie_iterator_init(struct alif_802154_ie_iterator *iter, uint8_t *ptr,
+				  uint16_t length)
+{
+	iter->ptr = ptr;
+	iter->remaining = length;
+}
 
-	if (mac_frame->mac_payload_length < 2) {
+bool alif_mac154_ie_header_next(struct alif_802154_ie_iterator *iter,
+				struct mac_header_IE_s *header_ie)
+{
+	if (iter->remaining < 2 || !mac_parse_header_ie(header_ie, iter->ptr)) {
 		return false;
 	}
-
-	ie_params->ie_header_ptr = ptr;
-
-	while (mac_frame->mac_payload_length >= 2) {
-		if (!mac_parse_header_ie(&header_ie, ptr)) {
-			return false;
-		}
-
-		mac_frame->mac_payload_length -= 2;
-		if (header_ie.length > mac_frame->mac_payload_length) {
-			return false;
-		}
-
-		mac_frame->mac_payload_length -= header_ie.length;
-		ie_params->ie_header_len += header_ie.length + 2;
-		ptr += (2 + header_ie.length);
-
-		if (header_ie.id == MAC_HEADER_TERMINATION1_IE_ID) {
-			ie_params->payload_ie_presents = true;
-			break;
-		} else if (header_ie.id == MAC_HEADER_TERMINATION2_IE_ID) {
-			/* Update Payload ptr */
-			break;
-		}
+	if (header_ie->length > iter->remaining - 2) {
+		return false;
 	}
-	/* Update Payload pointer start */
-	mac_frame->mac_payload = ptr;
-	/* Update Header leghth */
-	mac_frame->mac_header_length += ie_params->ie_header_len;
+
+	iter->ptr += header_ie->length + 2;
+	iter->remaining -= header_ie->length + 2;
 	return true;
 }
 
-static bool alif_mac154_payload_ie_parse(struct alif_802154_frame_parser *mac_frame)
+bool alif_mac154_ie_payload_next(struct alif_802154_ie_iterator *iter,
+				 struct mac_payload_IE_s *payload_ie)
 {
-	struct mac_payload_IE_s payload_ie;
-	uint8_t *ptr = mac_frame->mac_payload;
-	struct alif_802154_ie_params *ie_params = &mac_frame->ie_info;
-
-	if (!ie_params->payload_ie_presents) {
-		return true;
+	if (iter->remaining < 2 || !mac_parse_payload_ie(payload_ie, iter->ptr)) {
+		return false;
 	}
-
-	if (mac_frame->mac_payload_length < 2) {
+	if (payload_ie->length > iter->remaining - 2) {
 		return false;
 	}
 
-	ie_params->ie_payload_ptr = ptr;
-
-	while (mac_frame->mac_payload_length >= 2) {
-		if (!mac_parse_payload_ie(&payload_ie, ptr)) {
-			return false;
-		}
-
-		mac_frame->mac_payload_length -= 2;
-		if (payload_ie.length > mac_frame->mac_payload_length) {
-			return false;
-		}
-
-		mac_frame->mac_payload_length -= payload_ie.length;
+	iter->ptr += payload_ie->length + 2;
+	iter->remaining -= payload_ie->length + 2;
+	return true;
+}
 
-		if (payload_ie.id == MAC_PAYLOAD_TERMINATION_IE_GROUP_ID) {
-			break;
-		}
-		ie_params->ie_payload_len += payload_ie.length + 2;
-		mac_frame->mac_payload_length += payload_ie.length + 2;
-		ptr += (2 + payload_ie.length);
+static void alif_mac_fcf_parse(const uint8_t *p_frame, struct mac154_fcf *fcf)
+{
+	fcf->frame_type = alif_mac154_header_parser_frame_type(p_frame);
+	fcf->frame_version = alif_mac154_header_parser_frame_version(p_frame);
+	fcf->security_enabled = alif_mac154_header_parser_security_enabled(p_frame);
+	fcf->panid_compression = alif_mac154_header_parser_pan_id_compression(p_frame);
+	fcf->ack_requested = alif_mac154_header_parser_acknowledge_request(p_frame);
+	fcf->sam = alif_mac154_header_parser_src_addr_mode(p_frame);
+	fcf->dam = alif_mac154_header_parser_dst_addr_mode(p_frame);
+
+	if (fcf->frame_version <= MAC154_FRAME_VERSION_2006) {
+		fcf->seq_nb_suppression = false;
+		fcf->ie_elements = false;
+	} else {
+		fcf->seq_nb_suppression = alif_mac154_header_parser_seq_num_suppression(p_frame);
+		fcf->ie_elements = alif_mac154_header_parser_ie_present(p_frame);
 	}
 
-	mac_frame->mac_payload = ptr;
-	return true;
+	fcf->d_pan_id_present = destination_panid_is_present(fcf);
+	fcf->s_pan_id_present = source_panid_is_present(fcf);
 }
 
-static bool alif_mac_fcf_header_parse(struct alif_802154_frame_parser *mac_frame)
+bool alif_mac154_mac_frame_parse(struct alif_802154_frame_parser *mac_frame)
 {
 	struct alif_802154_header *frame_info = &mac_frame->gen_header;
+	struct alif_802154_ccm_params *ccm_params = &mac_frame->ccm_params;
+	struct alif_802154_ie_params *ie_params = &mac_frame->ie_info;
+	struct alif_802154_ie_iterator iter;
+	uint8_t *packet = mac_frame->mac_packet;
+	bool open_payload = true;
+	uint16_t offset = 2;
+	uint16_t end;
+	int dst_addr_len;
+	int src_addr_len;
+
+	memset(frame_info, 0, sizeof(*frame_info));
+	memset(ccm_params, 0, sizeof(*ccm_params));
+	memset(ie_params, 0, sizeof(*ie_params));
+	ccm_params->sec_level = MAC154_SECURITY_LEVEL_NONE;
+	/* Init packet encode state */
+	mac_frame->encoded_packet = false;
 
-	mac_frame->mac_header_length = 2;
-
-	/* Parse FCF */
-	frame_info->fcf.frame_type = alif_mac154_header_parser_frame_type(mac_frame->mac_packet);
-	frame_info->fcf.frame_version =
-		alif_mac154_header_parser_frame_version(mac_frame->mac_packet);
-	frame_info->fcf.security_enabled =
-		alif_mac154_header_parser_security_enabled(mac_frame->mac_packet);
-	frame_info->fcf.panid_compression =
-		alif_mac154_header_parser_pan_id_compression(mac_frame->mac_packet);
-	frame_info->fcf.ack_requested =
-		alif_mac154_header_parser_acknowledge_request(mac_frame->mac_packet);
-	frame_info->fcf.sam = alif_mac154_header_parser_src_addr_mode(mac_frame->mac_packet);
-	frame_info->fcf.dam = alif_mac154_header_parser_dst_addr_mode(mac_frame->mac_packet);
-
-	if (frame_info->fcf.frame_version <= MAC154_FRAME_VERSION_2006) {
-		frame_info->fcf.seq_nb_suppression = false;
-		frame_info->fcf.ie_elements = false;
-	} else {
-		frame_info->fcf.seq_nb_suppression =
-			alif_mac154_header_parser_seq_num_suppression(mac_frame->mac_packet);
-		frame_info->fcf.ie_elements =
-			alif_mac154_header_parser_ie_present(mac_frame->mac_packet);
+	if (mac_frame->mac_packet_length < 2 || mac_frame->mac_packet_length > UINT8_MAX) {
+		return false;
 	}
 
-	frame_info->fcf.d_pan_id_present = destination_panid_is_present(&frame_info->fcf);
-	frame_info->fcf.s_pan_id_present = source_panid_is_present(&frame_info->fcf);
+	/* Parse FCF and addressing fields */
+	alif_mac_fcf_parse(packet, &frame_info->fcf);
+
+	dst_addr_len = mac_address_length(frame_info->fcf.dam);
+	src_addr_len = mac_address_length(frame_info->fcf.sam);
+	if (dst_addr_len < 0 || src_addr_len < 0) {
+		return false;
+	}
 
 	if (!frame_info->fcf.seq_nb_suppression) {
 		/* Sequence number is present */
-		mac_frame->mac_header_length += 1;
+		offset += 1;
 	}
-
 	if (frame_info->fcf.d_pan_id_present) {
-		/* destination PANID is present */
-		frame_info->dst_pan_id_offset = mac_frame->mac_header_length;
-		mac_frame->mac_header_length += 2;
+		frame_info->dst_pan_id_offset = offset;
+		offset += 2;
 	}
-
-	frame_info->dst_addr_offset = mac_frame->mac_header_length;
-	if (frame_info->fcf.dam == MAC154_ADDRESSING_MODE_SHORT) {
-		/* short destination address is present */
-
-		mac_frame->mac_header_length += 2;
-	} else if (frame_info->fcf.dam == MAC154_ADDRESSING_MODE_EXTENDED) {
-		/* extended destination address is present */
-		mac_frame->mac_header_length += 8;
-	} else {
-		return false;
+	if (dst_addr_len) {
+		frame_info->dst_addr_offset = offset;
+		offset += dst_addr_len;
 	}
-
-	if (frame_info->fcf.s_pan_id_present) { /* source PANID is present */
-		frame_info->src_pan_id_offset = mac_frame->mac_header_length;
-		mac_frame->mac_header_length += 2;
+	if (frame_info->fcf.s_pan_id_present) {
+		frame_info->src_pan_id_offset = offset;
+		offset += 2;
 	}
-
-	frame_info->src_addr_offset = mac_frame->mac_header_length;
-	if (frame_info->fcf.sam == MAC154_ADDRESSING_MODE_SHORT) {
-		/* short destination address is present */
-		mac_frame->mac_header_length += 2;
-	} else if (frame_info->fcf.sam == MAC154_ADDRESSING_MODE_EXTENDED) {
-		/* extended destination address is present */
-		mac_frame->mac_header_length += 8;
-	} else {
-		return false;
+	if (src_addr_len) {
+		frame_info->src_addr_offset = offset;
+		offset += src_addr_len;
 	}
-	return true;
-}
-
-static bool alif_mac_security_header_parse(struct alif_802154_frame_parser *mac_frame)
-{
-	struct alif_802154_header *frame_info = &mac_frame->gen_header;
-	struct alif_802154_ccm_params *ccm_params = &mac_frame->ccm_params;
-
-	ccm_params->mic = NULL;
-	ccm_params->mic_len = 0;
-	ccm_params->sec_level = MAC154_SECURITY_LEVEL_NONE;
-	/* Init packet encode state */
-	mac_frame->encoded_packet = false;
 
+	/* Auxiliary security header */
 	if (frame_info->fcf.security_enabled) {
-		bool suppress_frame_conter =
-			alif_mac154_header_parser_scf_frame_counter_suppression(
-				mac_frame->mac_packet[mac_frame->mac_header_length]);
+		uint8_t scf;
 
-		if (mac_frame->mac_packet_length <
-		    mac_frame->mac_header_length + MAC154_SECURE_CONTROL_FIELD_SIZE) {
+		if (mac_frame->mac_packet_length < offset + MAC154_SECURE_CONTROL_FIELD_SIZE) {
 			return false;
 		}
 
-		ccm_params->sec_level = alif_mac154_header_parser_scf_security_level(
-			mac_frame->mac_packet[mac_frame->mac_header_length]);
-		ccm_params->key_id_mode = alif_mac154_header_parser_scf_key_identifier_mode(
-			mac_frame->mac_packet[mac_frame->mac_header_length]);
-		mac_frame->mac_header_length++;
-		ccm_params->mic_len =
-			alif_mac154_header_parser_scf_mic_length(ccm_params->sec_level);
-
-		/* Parse sec level and key-id mode */
-		if (!suppress_frame_conter) {
-			if (mac_frame->mac_packet_length < mac_frame->mac_header_length + 4) {
-				return false;
-			}
-			ccm_params->sec_frame_counter =
-				mac_frame->mac_packet + mac_frame->mac_header_length;
-			mac_frame->mac_header_length += 4;
-		} else {
-			ccm_params->sec_frame_counter = NULL;
+		frame_info->sec_header_offset = offset;
+		scf = packet[offset++];
+		ccm_params->sec_level = alif_mac154_header_parser_scf_security_level(scf);
+		ccm_params->key_id_mode = alif_mac154_header_parser_scf_key_identifier_mode(scf);
+		ccm_params->mic_len = alif_mac154_header_parser_scf_mic_length(ccm_params->sec_level);
+
+		if (!alif_mac154_header_parser_scf_frame_counter_suppression(scf)) {
+			ccm_params->sec_frame_counter = packet + offset;
+			offset += MAC154_SECURE_FRAME_COUNTER_SIZE;
 		}
 
 		if (ccm_params->key_id_mode != MAC154_KEY_IDENTIFIER_MODE_0) {
-
-			ccm_params->sec_key_source =
-				mac_frame->mac_packet + mac_frame->mac_header_length;
-			ccm_params->sec_key_source_len = 1;
-			ccm_params->sec_key_source_len +=
-				alif_mac154_header_parser_scf_key_identifier_length(
-					ccm_params->key_id_mode);
-			mac_frame->mac_header_length += ccm_params->sec_key_source_len;
-			if (mac_frame->mac_packet_length < mac_frame->mac_header_length) {
-				return false;
-			}
-		}
-		if (mac_frame->mac_packet_length <
-		    mac_frame->mac_header_length + ccm_params->mic_len) {
-			return false;
-		}
-		if (ccm_params->mic_len) {
-			ccm_params->mic = mac_frame->mac_packet +
-					  (mac_frame->mac_packet_length - ccm_params->mic_len);
+			ccm_params->sec_key_source = packet + offset;
+			ccm_params->sec_key_source_len =
+				1 + alif_mac154_header_parser_scf_key_identifier_length(
+					    ccm_params->key_id_mode);
+			offset += ccm_params->sec_key_source_len;
 		}
 	}
 
-	/* Set Payload pointer and length*/
-	mac_frame->mac_payload = mac_frame->mac_packet + mac_frame->mac_header_length;
-	mac_frame->mac_payload_length =
-		mac_frame->mac_packet_length - mac_frame->mac_header_length - ccm_params->mic_len;
-	return true;
-}
-
-static bool alif_mac154_ie_parse(struct alif_802154_frame_parser *mac_frame)
-{
-	bool open_payload = true;
+	if (mac_frame->mac_packet_length < offset + ccm_params->mic_len) {
+		return false;
+	}
+	end = mac_frame->mac_packet_length - ccm_params->mic_len;
+	if (ccm_params->mic_len) {
+		ccm_params->mic = packet + end;
+	}
 
-	mac_frame->ie_info.ie_header_ptr = NULL;
-	mac_frame->ie_info.ie_header_len = 0;
-	mac_frame->ie_info.ie_payload_ptr = NULL;
-	mac_frame->ie_info.ie_payload_len = 0;
-	mac_frame->ie_info.payload_ie_presents = false;
+	/* Header IEs, terminated by HT1/HT2 or by end of frame */
+	if (frame_info->fcf.ie_elements) {
+		struct mac_header_IE_s header_ie;
 
-	if (mac_frame->gen_header.fcf.ie_elements) {
-		if (!alif_mac154_header_ie_parse(mac_frame)) {
+		if (end - offset < 2) {
 			return false;
 		}
 
-		open_payload = mac_frame->ie_info.payload_ie_presents;
-
-		if (!alif_mac154_payload_ie_parse(mac_frame)) {
-			return false;
+		frame_info->ie_header_offset = offset;
+		alif_mac154_ie_iterator_init(&iter, packet + offset, end - offset);
+		while (iter.remaining >= 2) {
+			if (!alif_mac154_ie_header_next(&iter, &header_ie)) {
+				return false;
+			}
+			if (header_ie.id == MAC_HEADER_TERMINATION1_IE_ID) {
+				ie_params->payload_ie_presents = true;
+				break;
+			} else if (header_ie.id == MAC_HEADER_TERMINATION2_IE_ID) {
+				break;
+			}
 		}
+		ie_params->ie_header_ptr = packet + offset;
+		ie_params->ie_header_len = iter.ptr - ie_params->ie_header_ptr;
+		offset += ie_params->ie_header_len;
+		open_payload = ie_params->payload_ie_presents;
 	}
 
-	if (mac_frame->gen_header.fcf.frame_type == MAC154_FRAME_TYPE_COMMAND && open_payload) {
-		mac_frame->mac_header_length++;
-		mac_frame->mac_payload++;
-		mac_frame->mac_payload_length--;
-	}
+	/* Header ends here, payload IEs are part of the private payload */
+	frame_info->payload_offset = offset;
 
-	return true;
-}
+	if (ie_params->payload_ie_presents) {
+		struct mac_payload_IE_s payload_ie;
 
-bool alif_mac154_mac_frame_parse(struct alif_802154_frame_parser *mac_frame)
-{
+		if (end - offset < 2) {
+			return false;
+		}
 
-	/* Parse FCF */
-	if (!alif_mac_fcf_header_parse(mac_frame)) {
-		return false;
+		frame_info->ie_payload_offset = offset;
+		alif_mac154_ie_iterator_init(&iter, packet + offset, end - offset);
+		while (iter.remaining >= 2) {
+			uint8_t *ie_start = iter.ptr;
+
+			if (!alif_mac154_ie_payload_next(&iter, &payload_ie)) {
+				return false;
+			}
+			if (payload_ie.id == MAC_PAYLOAD_TERMINATION_IE_GROUP_ID) {
+				iter.ptr = ie_start;
+				break;
+			}
+		}
+		ie_params->ie_payload_ptr = packet + offset;
+		ie_params->ie_payload_len = iter.ptr - ie_params->ie_payload_ptr;
 	}
 
-	/*security header*/
-	if (!alif_mac_security_header_parse(mac_frame)) {
-		return false;
+	if (frame_info->fcf.frame_type == MAC154_FRAME_TYPE_COMMAND && open_payload) {
+		/* Command id is authenticated as part of header */
+		if (end - frame_info->payload_offset < 1) {
+			return false;
+		}
+		frame_info->payload_offset++;
 	}
 
-	return alif_mac154_ie_parse(mac_frame);
+	mac_frame->mac_header_length = frame_info->payload_offset;
+	mac_frame->mac_payload = packet + frame_info->payload_offset;
+	mac_frame->mac_payload_length = end - frame_info->payload_offset;
+	return true;
 }
 
 bool alif_mac154_ie_header_discover(uint8_t *header_ptr, uint16_t length,
 				    struct mac_header_IE_s *header_ie)
 {
+	struct alif_802154_ie_iterator iter;
 	struct mac_header_IE_s ie_element;
 
-	while (length >= 2) {
-		if (!mac_parse_header_ie(&ie_element, header_ptr)) {
-			return false;
-		}
+	alif_mac154_ie_iterator_init(&iter, header_ptr, length);
+
+	while (alif_mac154_ie_header_next(&iter, &ie_element)) {
 		if (header_ie->id == ie_element.id) {
 			header_ie->content_ptr = ie_element.content_ptr;
 			header_ie->length = ie_element.length;
 			return true;
 		}
-
-		length -= ie_element.length + 2;
-
-		header_ptr += ie_element.length + 2;
 	}
 	return false;
 }
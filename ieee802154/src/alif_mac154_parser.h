@@ -300,6 +300,9 @@ static inline uint8_t alif_mac154_header_parser_scf_mic_length(enum mac154_sec_l
 /**
  * @brief Parse 802.15.4 header.
  *
+ * Frame is parsed in a single pass and all field offsets are stored to
+ * gen_header. Frame data is not copied.
+ *
  * @param[in]	mac_frame pointer to Mac Frame
  *
  * @return	True Frame parsed succesfully
@@ -320,4 +323,38 @@ bool alif_mac154_mac_frame_parse(struct alif_802154_frame_parser *mac_frame);
 bool alif_mac154_ie_header_discover(uint8_t *header_ptr, uint16_t length,
 				    struct mac_header_IE_s *header_ie);
 
+/**
+ * @brief Init Information element iterator.
+ *
+ * @param[out]	iter Iterator
+ * @param[in]	ptr pointer to Information element field
+ * @param[in]	length length of Information element field
+ */
+void alif_mac154_ie_iterator_init(struct alif_802154_ie_iterator *iter, uint8_t *ptr,
+				  uint16_t length);
+
+/**
+ * @brief Get next Header information element.
+ *
+ * @param[in]	iter Iterator
+ * @param[out]	header_ie Parsed Information element
+ *
+ * @return	True Information element parsed and iterator moved past it
+ * @return	False End of field or malformed element
+ */
+bool alif_mac154_ie_header_next(struct alif_802154_ie_iterator *iter,
+				struct mac_header_IE_s *header_ie);
+
+/**
+ * @brief Get next Payload information element.
+ *
+ * @param[in]	iter Iterator
+ * @param[out]	payload_ie Parsed Information element
+ *
+ * @return	True Information element parsed and iterator moved past it
+ * @return	False End of field or malformed element
+ */
+bool alif_mac154_ie_payload_next(struct alif_802154_ie_iterator *iter,
+				 struct mac_payload_IE_s *payload_ie);
+
 #endif /* IEEE802154_SRC_ALIF_MAC154_PARSER_H_ */
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include "alif_mac154_timestamp.h"
+
+/* Shortest anchor interval used for rate estimation */
+#define TS_MODEL_RATE_MIN_INTERVAL_US 1000000LL
+/* Rate estimate filter, new sample weight 1 / 2^N */
+#define TS_MODEL_RATE_FILTER_SHIFT    2
+
+struct ts_model {
+	uint64_t anchor_host;
+	uint64_t anchor_radio;
+	/* Error of the anchor itself */
+	uint32_t anchor_err;
+	/* Rate estimation base, only ever a measured anchor */
+	uint64_t rate_host;
+	uint64_t rate_radio;
+	uint32_t rate_err;
+	/* Radio clock rate relative to host clock in parts per billion */
+	int32_t drift_ppb;
+	bool valid;
+	bool drift_valid;
+	/* Latest timestamp handed out, a new anchor must not step behind it */
+	uint64_t last_served;
+	uint32_t local_count;
+	uint32_t query_count;
+	uint32_t event_count;
+	uint32_t event_corrections;
+};
+
+static struct k_spinlock ts_model_lock;
+static struct ts_model ts_model;
+
+uint64_t alif_mac154_ts_model_host_time(void)
+{
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+	return k_cyc_to_us_floor64(k_cycle_get_64());
+#else
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+#endif
+}
+
+static uint64_t ts_model_predict(uint64_t host, uint32_t *p_err)
+{
+	int64_t elapsed = host - ts_model.anchor_host;
+	int64_t correction = (elapsed * ts_model.drift_ppb) / 1000000000LL;
+	uint64_t age = llabs(elapsed);
+
+	if (p_err) {
+		*p_err = ts_model.anchor_err +
+			 (uint32_t)((age * CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL_DRIFT_PPM) /
+				    1000000ULL);
+	}
+
+	return ts_model.anchor_radio + elapsed + correction;
+}
+
+/* Timestamps handed out never go backwards over a re-anchor */
+static uint64_t ts_model_serve(uint64_t timestamp)
+{
+	ts_model.last_served = MAX(ts_model.last_served, timestamp);
+	return ts_model.last_served;
+}
+
+static void ts_model_rate_update(uint64_t host, uint64_t radio, uint32_t err)
+{
+	int64_t elapsed = host - ts_model.rate_host;
+	int64_t offset;
+	int32_t drift_ppb;
+
+	/* Both anchor errors must stay below the assumed residual drift */
+	if (elapsed < TS_MODEL_RATE_MIN_INTERVAL_US ||
+	    (uint64_t)(err + ts_model.rate_err) * 1000000ULL >
+		    (uint64_t)elapsed * CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL_DRIFT_PPM) {
+		return;
+	}
+
+	offset = (int64_t)(radio - ts_model.rate_radio) - elapsed;
+	drift_ppb = (int32_t)((offset * 1000000000LL) / elapsed);
+
+	if (ts_model.drift_valid) {
+		ts_model.drift_ppb +=
+			(drift_ppb - ts_model.drift_ppb) >> TS_MODEL_RATE_FILTER_SHIFT;
+	} else {
+		ts_model.drift_ppb = drift_ppb;
+		ts_model.drift_valid = true;
+	}
+
+	ts_model.rate_host = host;
+	ts_model.rate_radio = radio;
+	ts_model.rate_err = err;
+}
+
+/* Take a measured host / radio time pair, force when the model is proven wrong */
+static void ts_model_anchor(uint64_t host, uint64_t radio, uint32_t err, bool force)
+{
+	uint32_t predicted_err;
+
+	if (!ts_model.valid) {
+		ts_model.rate_host = host;
+		ts_model.rate_radio = radio;
+		ts_model.rate_err = err;
+	} else {
+		ts_model_rate_update(host, radio, err);
+		ts_model_predict(host, &predicted_err);
+		if (!force && err > predicted_err) {
+			/* Model is still tighter than the new measurement */
+			return;
+		}
+	}
+
+	ts_model.anchor_host = host;
+	ts_model.anchor_radio = radio;
+	ts_model.anchor_err = err;
+	ts_model.valid = true;
+}
+
+bool alif_mac154_ts_model_get(uint64_t *p_timestamp)
+{
+	k_spinlock_key_t key = k_spin_lock(&ts_model_lock);
+	bool ret = false;
+	uint32_t err;
+
+	if (ts_model.valid) {
+		uint64_t timestamp = ts_model_predict(alif_mac154_ts_model_host_time(), &err);
+
+		if (err <= CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL_MAX_ERROR_US) {
+			*p_timestamp = ts_model_serve(timestamp);
+			ts_model.local_count++;
+			ret = true;
+		}
+	}
+
+	k_spin_unlock(&ts_model_lock, key);
+	return ret;
+}
+
+void alif_mac154_ts_model_query_update(uint64_t host_start, uint64_t host_end,
+				       uint64_t *p_timestamp)
+{
+	k_spinlock_key_t key = k_spin_lock(&ts_model_lock);
+	/* Radio sampled somewhere between request and response, assume middle */
+	uint64_t host = host_start + (host_end - host_start) / 2;
+	uint32_t err = (uint32_t)((host_end - host_start) / 2);
+
+	ts_model.query_count++;
+	ts_model_anchor(host, *p_timestamp, err, false);
+	*p_timestamp = ts_model_serve(*p_timestamp);
+
+	k_spin_unlock(&ts_model_lock, key);
+}
+
+void alif_mac154_ts_model_event_update(uint64_t timestamp, uint64_t host_rx, uint32_t latency_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&ts_model_lock);
+	/* Unknown part of the latency is up to the slack, assume middle */
+	uint32_t err = CONFIG_IEEE802154_ALIF_TIMESTAMP_MODEL_EVENT_SLACK_US / 2;
+	uint64_t host = host_rx - latency_us - err;
+	bool force = false;
+
+	ts_model.event_count++;
+
+	/* Event seen on host at host_rx, radio time then was at least the timestamp */
+	if (ts_model.valid && timestamp > ts_model_predict(host_rx, NULL)) {
+		ts_model.event_corrections++;
+		force = true;
+	}
+	ts_model_anchor(host, timestamp, err, force);
+
+	k_spin_unlock(&ts_model_lock, key);
+}
+
+void alif_mac154_ts_model_info_get(struct alif_mac154_timestamp_model_info *p_info)
+{
+	k_spinlock_key_t key = k_spin_lock(&ts_model_lock);
+	uint64_t host = alif_mac154_ts_model_host_time();
+	uint32_t err = 0;
+
+	if (ts_model.valid) {
+		ts_model_predict(host, &err);
+	}
+
+	p_info->valid = ts_model.valid;
+	p_info->drift_ppb = ts_model.drift_ppb;
+	p_info->error_us = err;
+	p_info->anchor_age_ms = ts_model.valid ? (host - ts_model.anchor_host) / 1000 : 0;
+	p_info->local_count = ts_model.local_count;
+	p_info->query_count = ts_model.query_count;
+	p_info->event_count = ts_model.event_count;
+	p_info->event_corrections = ts_model.event_corrections;
+
+	k_spin_unlock(&ts_model_lock, key);
+}
+
+void alif_mac154_ts_model_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ts_model_lock);
+
+	ts_model.valid = false;
+	ts_model.drift_valid = false;
+	ts_model.drift_ppb = 0;
+	/* Link layer reset restarts the radio timebase */
+	ts_model.last_served = 0;
+
+	k_spin_unlock(&ts_model_lock, key);
+}
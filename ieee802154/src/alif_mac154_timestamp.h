@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IEEE802154_ALIF_TIMESTAMP_H_
+#define IEEE802154_ALIF_TIMESTAMP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alif_mac154_api.h"
+
+/**
+ * @brief Get host time used as model input.
+ *
+ * @return	Host time in us
+ */
+uint64_t alif_mac154_ts_model_host_time(void);
+
+/**
+ * @brief Get radio timestamp from the model.
+ *
+ * Served timestamps never decrease, a later anchor that puts the radio
+ * clock behind an earlier answer holds the time until the model catches up.
+ *
+ * @param[out]	p_timestamp Estimated radio timestamp in us
+ *
+ * @return	True Estimate is within the configured error bound
+ * @return	False Model must be refreshed with a link layer query
+ */
+bool alif_mac154_ts_model_get(uint64_t *p_timestamp);
+
+/**
+ * @brief Refresh the model from an explicit timestamp query.
+ *
+ * @param[in]	host_start Host time when query was sent
+ * @param[in]	host_end Host time when response was received
+ * @param[in,out] p_timestamp Radio timestamp from the response, raised to
+ *			the latest served one if the model ran ahead of it
+ */
+void alif_mac154_ts_model_query_update(uint64_t host_start, uint64_t host_end,
+				       uint64_t *p_timestamp);
+
+/**
+ * @brief Refresh the model from a received frame or ACK timestamp.
+ *
+ * The event is anchored at host_rx - latency_us. The link layer processing
+ * and host interrupt delay on top of the known latency are covered by the
+ * configured event slack.
+ *
+ * @param[in]	timestamp Radio timestamp of the event
+ * @param[in]	host_rx Host time when the event indication was received
+ * @param[in]	latency_us Known delay from the event to host_rx
+ */
+void alif_mac154_ts_model_event_update(uint64_t timestamp, uint64_t host_rx, uint32_t latency_us);
+
+/**
+ * @brief Get model state.
+ *
+ * @param[out]	p_info Model state
+ */
+void alif_mac154_ts_model_info_get(struct alif_mac154_timestamp_model_info *p_info);
+
+/**
+ * @brief Drop the model, next timestamp is queried from link layer.
+ */
+void alif_mac154_ts_model_reset(void);
+
+#endif /* IEEE802154_ALIF_TIMESTAMP_H_ */
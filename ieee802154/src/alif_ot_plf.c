@@ -5,10 +5,20 @@
  */
 
 #include <openthread/instance.h>
+#include <openthread/platform/radio.h>
+
+#include "alif_mac154_api.h"
 
 uint32_t otPlatRadioGetBusSpeed(otInstance *aInstance)
 {
 	OT_UNUSED_VARIABLE(aInstance);
 	/* Adjusting openthread timing based on radio bus speed*/
-	return 250000;
+	return alif_mac154_bus_speed_get();
+}
+
+uint32_t otPlatRadioGetBusLatency(otInstance *aInstance)
+{
+	OT_UNUSED_VARIABLE(aInstance);
+	/* Measured link layer command round-trip time */
+	return alif_mac154_bus_latency_get();
 }
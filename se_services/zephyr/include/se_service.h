@@ -9,6 +9,9 @@ extern "C" {
 #include <services_lib_api.h>
 #include <services_lib_ids.h>
 
+#if defined(CONFIG_SE_SERVICE_IPM_OVERRIDE)
+int se_service_ipm_devices_set(const struct device *send, const struct device *recv);
+#endif
 int se_service_heartbeat(void);
 int se_service_sync(void);
 int se_service_system_set_services_debug(bool debug_enable);
@@ -19,6 +22,7 @@ int se_service_get_toc_version(uint32_t *pversion);
 int se_service_get_device_part_number(uint32_t *pdev_part);
 int se_service_system_get_device_data(get_device_revision_data_t *pdev_data);
 int se_system_get_eui_extension(bool is_eui48, uint8_t *eui_extension);
+void se_service_cache_invalidate(void);
 
 int se_service_boot_es0(uint8_t *nvds_buff, uint16_t nvds_size, uint32_t clock_select);
 int se_service_shutdown_es0(void);
@@ -30,6 +34,23 @@ int se_service_se_sleep_req(uint32_t param);
 int se_service_boot_reset_soc(void);
 int se_service_boot_reset_cpu(uint32_t cpu_id);
 int se_service_process_toc_entry(const char *image_id);
+
+/* Completion of an asynchronous request, called from the SE service thread */
+typedef void (*se_service_async_cb_t)(int result, void *user_data);
+
+struct se_service_async {
+	/* Optional callback */
+	se_service_async_cb_t cb;
+	/* Optional poll signal, raised with the result (requires CONFIG_POLL) */
+	struct k_poll_signal *signal;
+	void *user_data;
+};
+
+int se_service_heartbeat_async(const struct se_service_async *done);
+int se_service_get_rnd_num_async(uint8_t *buffer, uint16_t length,
+				 const struct se_service_async *done);
+int se_service_set_run_cfg_async(const run_profile_t *pp, const struct se_service_async *done);
+int se_service_set_off_cfg_async(const off_profile_t *wp, const struct se_service_async *done);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,153 @@
+/* Copyright (C) 2024  Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/entropy.h>
+#include <se_service.h>
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(se_entropy, CONFIG_ENTROPY_LOG_LEVEL);
+
+#define DT_DRV_COMPAT alif_se_entropy
+
+#define POOL_SIZE CONFIG_ENTROPY_ALIF_SE_POOL_SIZE
+
+BUILD_ASSERT(CONFIG_ENTROPY_ALIF_SE_WATERMARK < POOL_SIZE,
+	     "Entropy pool watermark must be below pool size");
+
+struct se_entropy_data {
+	struct k_spinlock lock;
+	/* Free running indexes, level is wr - rd */
+	uint32_t rd;
+	uint32_t wr;
+	uint8_t pool[POOL_SIZE];
+	struct k_work refill_work;
+	struct k_work_q refill_q;
+};
+
+static K_THREAD_STACK_DEFINE(se_entropy_stack, CONFIG_ENTROPY_ALIF_SE_WORKQ_STACK_SIZE);
+static struct se_entropy_data se_entropy_data;
+
+/**
+ * @brief Copy random bytes out of the pool.
+ *
+ * returns,
+ * number of bytes copied, less than len when pool runs empty.
+ */
+static uint16_t pool_take(struct se_entropy_data *data, uint8_t *buf, uint16_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+	uint16_t n = MIN(len, data->wr - data->rd);
+
+	for (uint16_t i = 0; i < n; i++) {
+		uint32_t idx = data->rd++ % POOL_SIZE;
+
+		buf[i] = data->pool[idx];
+		/* Do not leave served bytes behind in RAM */
+		data->pool[idx] = 0;
+	}
+	if (data->wr - data->rd < CONFIG_ENTROPY_ALIF_SE_WATERMARK) {
+		k_work_submit_to_queue(&data->refill_q, &data->refill_work);
+	}
+	k_spin_unlock(&data->lock, key);
+
+	return n;
+}
+
+static void pool_put(struct se_entropy_data *data, const uint8_t *buf, uint16_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+	uint16_t n = MIN(len, POOL_SIZE - (data->wr - data->rd));
+
+	for (uint16_t i = 0; i < n; i++) {
+		data->pool[data->wr++ % POOL_SIZE] = buf[i];
+	}
+	k_spin_unlock(&data->lock, key);
+}
+
+static uint32_t pool_free(struct se_entropy_data *data)
+{
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+	uint32_t free = POOL_SIZE - (data->wr - data->rd);
+
+	k_spin_unlock(&data->lock, key);
+	return free;
+}
+
+static void se_entropy_refill(struct k_work *work)
+{
+	struct se_entropy_data *data = CONTAINER_OF(work, struct se_entropy_data, refill_work);
+	uint8_t chunk[MAX_RND_LENGTH];
+	uint32_t free;
+	int err;
+
+	/* Fill the whole pool with as few SE round-trips as possible */
+	while ((free = pool_free(data)) > 0) {
+		uint16_t len = MIN(free, sizeof(chunk));
+
+		err = se_service_get_rnd_num(chunk, len);
+		if (err) {
+			LOG_ERR("pool refill failed (%d)", err);
+			break;
+		}
+		pool_put(data, chunk, len);
+	}
+	memset(chunk, 0, sizeof(chunk));
+}
+
+static int se_entropy_get_entropy(const struct device *dev, uint8_t *buffer, uint16_t length)
+{
+	struct se_entropy_data *data = dev->data;
+	uint16_t n = pool_take(data, buffer, length);
+	int err;
+
+	/* Pool ran dry, fetch the rest directly */
+	while (n < length) {
+		uint16_t len = MIN(length - n, MAX_RND_LENGTH);
+
+		err = se_service_get_rnd_num(&buffer[n], len);
+		if (err) {
+			return -EIO;
+		}
+		n += len;
+	}
+
+	return 0;
+}
+
+static int se_entropy_get_entropy_isr(const struct device *dev, uint8_t *buffer,
+				      uint16_t length, uint32_t flags)
+{
+	struct se_entropy_data *data = dev->data;
+
+	ARG_UNUSED(flags);
+
+	/* SE cannot be waited for in interrupt context, even with ENTROPY_BUSYWAIT */
+	return pool_take(data, buffer, length);
+}
+
+static const struct entropy_driver_api se_entropy_api = {
+	.get_entropy = se_entropy_get_entropy,
+	.get_entropy_isr = se_entropy_get_entropy_isr,
+};
+
+static int se_entropy_init(const struct device *dev)
+{
+	struct se_entropy_data *data = dev->data;
+
+	k_work_init(&data->refill_work, se_entropy_refill);
+	k_work_queue_start(&data->refill_q, se_entropy_stack,
+			   K_THREAD_STACK_SIZEOF(se_entropy_stack),
+			   CONFIG_ENTROPY_ALIF_SE_WORKQ_PRIORITY, NULL);
+	k_thread_name_set(&data->refill_q.thread, "se_entropy");
+
+	/* Initial fill runs in the background, early requests go to SE */
+	k_work_submit_to_queue(&data->refill_q, &data->refill_work);
+
+	return 0;
+}
+
+DEVICE_DT_INST_DEFINE(0, se_entropy_init, NULL, &se_entropy_data, NULL, POST_KERNEL,
+		      CONFIG_ENTROPY_INIT_PRIORITY, &se_entropy_api);
@@ -7,6 +7,7 @@
 #include <zephyr/drivers/ipm.h>
 #include <se_service.h>
 #include <soc_memory_map.h>
+#include "se_service_stats.h"
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(se_service, CONFIG_IPM_LOG_LEVEL);
 
@@ -27,6 +28,22 @@ const struct device *send_dev;
 const struct device *recv_dev;
 static uint32_t se_toc_version;
 
+/* Responses of services which never change while running */
+enum se_cache_item {
+	SE_CACHE_PART_NUMBER,
+	SE_CACHE_SE_REVISION,
+	SE_CACHE_DEVICE_DATA,
+};
+
+static struct k_spinlock se_cache_lock;
+static struct {
+	uint32_t valid;
+	uint32_t part_number;
+	uint32_t se_revision_len;
+	uint8_t se_revision[VERSION_RESPONSE_LENGTH];
+	get_device_revision_data_t device_data;
+} se_cache;
+
 /* Manufacturing data for older Ensemble Family revision <= REV_B2 */
 typedef struct {
 	uint8_t x_loc: 7;
@@ -82,6 +99,66 @@ static se_service_all_svc_t se_service_all_svc_d;
 static uint32_t global_address;
 static uint32_t se_service_recv_data;
 
+static bool se_cache_read(enum se_cache_item item, void *dst, const void *src, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_cache_lock);
+	bool hit = se_cache.valid & BIT(item);
+
+	if (hit) {
+		memcpy(dst, src, len);
+	}
+	k_spin_unlock(&se_cache_lock, key);
+	return hit;
+}
+
+static void se_cache_write(enum se_cache_item item, void *dst, const void *src, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_cache_lock);
+
+	memcpy(dst, src, len);
+	se_cache.valid |= BIT(item);
+	k_spin_unlock(&se_cache_lock, key);
+}
+
+/* Revision length is only known with the data, both change under the lock */
+static bool se_cache_revision_read(uint8_t *dst)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_cache_lock);
+	bool hit = se_cache.valid & BIT(SE_CACHE_SE_REVISION);
+
+	if (hit) {
+		memcpy(dst, se_cache.se_revision, se_cache.se_revision_len);
+	}
+	k_spin_unlock(&se_cache_lock, key);
+	return hit;
+}
+
+static void se_cache_revision_write(const uint8_t *src, uint32_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_cache_lock);
+
+	se_cache.se_revision_len = MIN(VERSION_RESPONSE_LENGTH, len);
+	memcpy(se_cache.se_revision, src, se_cache.se_revision_len);
+	se_cache.valid |= BIT(SE_CACHE_SE_REVISION);
+	k_spin_unlock(&se_cache_lock, key);
+}
+
+/**
+ * @brief Drop cached responses of immutable services.
+ *
+ * TOC version, SE revision, part number and device data are read from SE
+ * once and served from RAM after that. Next call after invalidate queries
+ * SE again, e.g. after SE firmware update.
+ */
+void se_service_cache_invalidate(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_cache_lock);
+
+	se_cache.valid = 0;
+	se_toc_version = 0;
+	k_spin_unlock(&se_cache_lock, key);
+}
+
 /**
  * @brief Callback API to make sure MHUv2 messages are received.
  *
@@ -141,17 +218,28 @@ static void callback_for_send_msg(const struct device *dev, void *user_data,
  * @ptr     - placeholder for data to be sent.
  * @size    - size of data.
  * @timeout - Timeout in milliseconds.
+ * @p_ack   - set to cycle count when SE acknowledged the request.
+ * @p_acked - set to true once SE acknowledged the request.
  *
  * returns,
  * 0      - success.
  * err    - unable to send data.
  * -ETIME - semphores are timed out.
  */
-static int send_msg_to_se(uint32_t *ptr, uint32_t size, uint32_t timeout)
+static int se_msg_transfer(uint32_t *ptr, uint32_t size, uint32_t timeout, uint32_t *p_ack,
+			   bool *p_acked)
 {
 	int err;
 	int service_id = ((service_header_t *)ptr)->hdr_service_id;
 
+	*p_acked = false;
+
+#if defined(CONFIG_SE_SERVICE_IPM_OVERRIDE)
+	if (!send_dev || !recv_dev) {
+		return -ENODEV;
+	}
+#endif
+
 	global_address = local_to_global(ptr);
 	__asm__ volatile("dmb 0xF" ::: "memory");
 	sys_cache_data_flush_range(ptr, size);
@@ -171,6 +259,8 @@ static int send_msg_to_se(uint32_t *ptr, uint32_t size, uint32_t timeout)
 			k_sem_reset(&svc_send_sem);
 			return -ETIME;
 		}
+		*p_ack = k_cycle_get_32();
+		*p_acked = true;
 		if (k_sem_take(&svc_recv_sem, K_MSEC(timeout)) != 0) {
 			LOG_ERR("service %d response is timed out!\n", service_id);
 			k_sem_reset(&svc_recv_sem);
@@ -187,23 +277,57 @@ static int send_msg_to_se(uint32_t *ptr, uint32_t size, uint32_t timeout)
 					(int)size, K_MSEC(timeout));
 		if (err) {
 			LOG_ERR("failed to send service %d\n", service_id);
+			ipm_set_enabled(recv_dev, true);
 			return err;
 		}
+		*p_ack = k_cycle_get_32();
+		*p_acked = true;
 
 		err = ipm_poll_in(recv_dev, CH_ID, &rx_data,
 				(int)size, K_MSEC(timeout));
+		/* Enable Rx MHU interrupts */
+		ipm_set_enabled(recv_dev, true);
 		if (err) {
 			LOG_ERR("failed to rcv resp for service %d\n", service_id);
 			return err;
 		}
-		/* Enable Rx MHU interrupts */
-		ipm_set_enabled(recv_dev, true);
 	}
 
 	sys_cache_data_invd_range(ptr, size);
 	return 0;
 }
 
+/**
+ * @brief Send data to SE and record the round-trip when statistics are on.
+ *
+ * parameters,
+ * @ptr     - placeholder for data to be sent.
+ * @size    - size of data.
+ * @timeout - Timeout in milliseconds.
+ *
+ * returns,
+ * result of se_msg_transfer.
+ */
+static int send_msg_to_se(uint32_t *ptr, uint32_t size, uint32_t timeout)
+{
+	uint32_t start = k_cycle_get_32();
+	uint32_t ack = start;
+	bool polled = !k_can_yield();
+	bool acked;
+	int err;
+
+	err = se_msg_transfer(ptr, size, timeout, &ack, &acked);
+
+	if (IS_ENABLED(CONFIG_SE_SERVICE_STATS)) {
+		uint32_t end = k_cycle_get_32();
+
+		se_service_stats_record(((service_header_t *)ptr)->hdr_service_id, polled,
+					acked ? k_cyc_to_us_ceil32(ack - start) : 0,
+					acked && !err ? k_cyc_to_us_ceil32(end - ack) : 0, err);
+	}
+	return err;
+}
+
 /**
  * @brief Synchronize with SE or wait until SE wakes up by sending
  * multiple SE heartbeat service requests.
@@ -236,6 +360,9 @@ int se_service_sync(void)
 		++i;
 	}
 	k_mutex_unlock(&svc_mutex);
+	if (IS_ENABLED(CONFIG_SE_SERVICE_STATS)) {
+		se_service_stats_sync_record(i, i >= MAX_TRIES ? err : 0);
+	}
 	if (i >= MAX_TRIES) {
 		LOG_ERR("Failed to synchronize with SE (errno =%d)\n", err);
 		return err;
@@ -467,6 +594,9 @@ int se_service_get_se_revision(uint8_t *prev)
 		LOG_ERR("Invalid argument\n");
 		return -EINVAL;
 	}
+	if (se_cache_revision_read(prev)) {
+		return 0;
+	}
 
 	err = k_mutex_lock(&svc_mutex, K_MSEC(MUTEX_TIMEOUT));
 
@@ -493,6 +623,8 @@ int se_service_get_se_revision(uint8_t *prev)
 	}
 	memcpy(prev, (uint8_t *)se_service_all_svc_d.get_se_revision_svc_d.resp_se_revision,
 	       se_service_all_svc_d.get_se_revision_svc_d.resp_se_revision_length);
+	se_cache_revision_write(prev,
+				se_service_all_svc_d.get_se_revision_svc_d.resp_se_revision_length);
 
 	return 0;
 }
@@ -520,6 +652,10 @@ int se_service_get_device_part_number(uint32_t *pdev_part)
 		LOG_ERR("Invalid argument\n");
 		return -EINVAL;
 	}
+	if (se_cache_read(SE_CACHE_PART_NUMBER, pdev_part, &se_cache.part_number,
+			  sizeof(se_cache.part_number))) {
+		return 0;
+	}
 
 	err = k_mutex_lock(&svc_mutex, K_MSEC(MUTEX_TIMEOUT));
 
@@ -545,6 +681,8 @@ int se_service_get_device_part_number(uint32_t *pdev_part)
 		return resp_err;
 	}
 	*pdev_part = se_service_all_svc_d.get_device_part_svc_d.resp_device_string;
+	se_cache_write(SE_CACHE_PART_NUMBER, &se_cache.part_number, pdev_part,
+		       sizeof(se_cache.part_number));
 
 	return 0;
 }
@@ -632,6 +770,10 @@ int se_service_system_get_device_data(get_device_revision_data_t *pdev_data)
 		LOG_ERR("Invalid argument\n");
 		return -EINVAL;
 	}
+	if (se_cache_read(SE_CACHE_DEVICE_DATA, pdev_data, &se_cache.device_data,
+			  sizeof(se_cache.device_data))) {
+		return 0;
+	}
 
 	err = k_mutex_lock(&svc_mutex, K_MSEC(MUTEX_TIMEOUT));
 
@@ -687,6 +829,8 @@ int se_service_system_get_device_data(get_device_revision_data_t *pdev_data)
 	pdev_data->LCS = se_service_all_svc_d.get_device_revision_data_d.LCS;
 
 	k_mutex_unlock(&svc_mutex);
+	se_cache_write(SE_CACHE_DEVICE_DATA, &se_cache.device_data, pdev_data,
+		       sizeof(se_cache.device_data));
 	return 0;
 }
 
@@ -913,6 +1057,40 @@ int se_service_shutdown_es0(void)
 	return 0;
 }
 
+static void set_run_cfg_fill(aipm_set_run_profile_svc_t *p_svc, const run_profile_t *pp)
+{
+	p_svc->header.hdr_service_id = SERVICE_POWER_SET_RUN_REQ_ID;
+	p_svc->send_aon_clk_src = pp->aon_clk_src;
+	p_svc->send_run_clk_src = pp->run_clk_src;
+	p_svc->send_cpu_clk_freq = pp->cpu_clk_freq;
+	p_svc->send_scaled_clk_freq = pp->scaled_clk_freq;
+	p_svc->send_dcdc_mode = pp->dcdc_mode;
+	p_svc->send_dcdc_voltage = pp->dcdc_voltage;
+	p_svc->send_memory_blocks = pp->memory_blocks;
+	p_svc->send_ip_clock_gating = pp->ip_clock_gating;
+	p_svc->send_phy_pwr_gating = pp->phy_pwr_gating;
+	p_svc->send_power_domains = pp->power_domains;
+	p_svc->send_vdd_ioflex_3V3 = pp->vdd_ioflex_3V3;
+}
+
+static void set_off_cfg_fill(aipm_set_off_profile_svc_t *p_svc, const off_profile_t *wp)
+{
+	p_svc->header.hdr_service_id = SERVICE_POWER_SET_OFF_REQ_ID;
+	p_svc->send_dcdc_voltage = wp->dcdc_voltage;
+	p_svc->send_memory_blocks = wp->memory_blocks;
+	p_svc->send_power_domains = wp->power_domains;
+	p_svc->send_aon_clk_src = wp->aon_clk_src;
+	p_svc->send_stby_clk_src = wp->stby_clk_src;
+	p_svc->send_stby_clk_freq = wp->stby_clk_freq;
+	p_svc->send_ip_clock_gating = wp->ip_clock_gating;
+	p_svc->send_phy_pwr_gating = wp->phy_pwr_gating;
+	p_svc->send_vdd_ioflex_3V3 = wp->vdd_ioflex_3V3;
+	p_svc->send_vtor_address = wp->vtor_address;
+	p_svc->send_vtor_address_ns = wp->vtor_address_ns;
+	p_svc->send_wakeup_events = wp->wakeup_events;
+	p_svc->send_ewic_cfg = wp->ewic_cfg;
+}
+
 int se_service_get_run_cfg(run_profile_t *pp)
 {
 	int err, resp_err = -1;
@@ -971,18 +1149,7 @@ int se_service_set_run_cfg(run_profile_t *pp)
 
 	memset(&se_service_all_svc_d, 0, sizeof(se_service_all_svc_d));
 
-	se_service_all_svc_d.set_run_d.header.hdr_service_id = SERVICE_POWER_SET_RUN_REQ_ID;
-	se_service_all_svc_d.set_run_d.send_aon_clk_src = pp->aon_clk_src;
-	se_service_all_svc_d.set_run_d.send_run_clk_src = pp->run_clk_src;
-	se_service_all_svc_d.set_run_d.send_cpu_clk_freq = pp->cpu_clk_freq;
-	se_service_all_svc_d.set_run_d.send_scaled_clk_freq = pp->scaled_clk_freq;
-	se_service_all_svc_d.set_run_d.send_dcdc_mode = pp->dcdc_mode;
-	se_service_all_svc_d.set_run_d.send_dcdc_voltage = pp->dcdc_voltage;
-	se_service_all_svc_d.set_run_d.send_memory_blocks = pp->memory_blocks;
-	se_service_all_svc_d.set_run_d.send_ip_clock_gating = pp->ip_clock_gating;
-	se_service_all_svc_d.set_run_d.send_phy_pwr_gating = pp->phy_pwr_gating;
-	se_service_all_svc_d.set_run_d.send_power_domains = pp->power_domains;
-	se_service_all_svc_d.set_run_d.send_vdd_ioflex_3V3 = pp->vdd_ioflex_3V3;
+	set_run_cfg_fill(&se_service_all_svc_d.set_run_d, pp);
 
 	err = send_msg_to_se((uint32_t *)&se_service_all_svc_d.set_run_d,
 			     sizeof(se_service_all_svc_d.set_run_d), SERVICE_TIMEOUT);
@@ -1058,20 +1225,7 @@ int se_service_set_off_cfg(off_profile_t *wp)
 	}
 
 	memset(&se_service_all_svc_d, 0, sizeof(se_service_all_svc_d));
-	se_service_all_svc_d.set_off_d.header.hdr_service_id = SERVICE_POWER_SET_OFF_REQ_ID;
-	se_service_all_svc_d.set_off_d.send_dcdc_voltage = wp->dcdc_voltage;
-	se_service_all_svc_d.set_off_d.send_memory_blocks = wp->memory_blocks;
-	se_service_all_svc_d.set_off_d.send_power_domains = wp->power_domains;
-	se_service_all_svc_d.set_off_d.send_aon_clk_src = wp->aon_clk_src;
-	se_service_all_svc_d.set_off_d.send_stby_clk_src = wp->stby_clk_src;
-	se_service_all_svc_d.set_off_d.send_stby_clk_freq = wp->stby_clk_freq;
-	se_service_all_svc_d.set_off_d.send_ip_clock_gating = wp->ip_clock_gating;
-	se_service_all_svc_d.set_off_d.send_phy_pwr_gating = wp->phy_pwr_gating;
-	se_service_all_svc_d.set_off_d.send_vdd_ioflex_3V3 = wp->vdd_ioflex_3V3;
-	se_service_all_svc_d.set_off_d.send_vtor_address = wp->vtor_address;
-	se_service_all_svc_d.set_off_d.send_vtor_address_ns = wp->vtor_address_ns;
-	se_service_all_svc_d.set_off_d.send_wakeup_events = wp->wakeup_events;
-	se_service_all_svc_d.set_off_d.send_ewic_cfg = wp->ewic_cfg;
+	set_off_cfg_fill(&se_service_all_svc_d.set_off_d, wp);
 
 	err = send_msg_to_se((uint32_t *)&se_service_all_svc_d.set_off_d,
 			     sizeof(se_service_all_svc_d.set_off_d), SERVICE_TIMEOUT);
@@ -1267,24 +1421,261 @@ int se_service_process_toc_entry(const char *image_id)
 	return 0;
 }
 
+#if defined(CONFIG_SE_SERVICE_ASYNC)
+/* Request packet is invalidated after the response, keep it on own cache lines */
+#define SVC_CACHE_LINE 32
+
+struct se_service_async_slot {
+	int (*complete)(struct se_service_async_slot *p_slot);
+	void *resp_buf;
+	uint16_t resp_len;
+	uint32_t size;
+	struct se_service_async done;
+	se_service_all_svc_t svc __aligned(SVC_CACHE_LINE);
+} __aligned(SVC_CACHE_LINE);
+
+K_MEM_SLAB_DEFINE_STATIC(async_slab, sizeof(struct se_service_async_slot),
+			 CONFIG_SE_SERVICE_ASYNC_SLOTS, SVC_CACHE_LINE);
+K_MSGQ_DEFINE(async_msgq, sizeof(struct se_service_async_slot *),
+	      CONFIG_SE_SERVICE_ASYNC_SLOTS, sizeof(void *));
+
+static int async_slot_alloc(const struct se_service_async *done,
+			    struct se_service_async_slot **pp_slot)
+{
+	struct se_service_async_slot *p_slot;
+
+	if (!done || (!done->cb && !done->signal)) {
+		return -EINVAL;
+	}
+	if (k_mem_slab_alloc(&async_slab, (void **)&p_slot, K_NO_WAIT) != 0) {
+		return -ENOMEM;
+	}
+	memset(p_slot, 0, sizeof(*p_slot));
+	p_slot->done = *done;
+	*pp_slot = p_slot;
+	return 0;
+}
+
+static int async_slot_submit(struct se_service_async_slot *p_slot, uint32_t size,
+			     int (*complete)(struct se_service_async_slot *p_slot))
+{
+	p_slot->size = size;
+	p_slot->complete = complete;
+
+	/* Queue holds every slot, put cannot fail for an allocated slot */
+	return k_msgq_put(&async_msgq, &p_slot, K_NO_WAIT);
+}
+
+static int async_heartbeat_complete(struct se_service_async_slot *p_slot)
+{
+	ARG_UNUSED(p_slot);
+	return 0;
+}
+
+static int async_rnd_complete(struct se_service_async_slot *p_slot)
+{
+	int resp_err = p_slot->svc.get_rnd_svc_d.resp_error_code;
+
+	if (!resp_err) {
+		memcpy(p_slot->resp_buf, (uint8_t *)p_slot->svc.get_rnd_svc_d.resp_rnd,
+		       p_slot->resp_len);
+	}
+	return resp_err;
+}
+
+static int async_set_run_complete(struct se_service_async_slot *p_slot)
+{
+	return p_slot->svc.set_run_d.resp_error_code;
+}
+
+static int async_set_off_complete(struct se_service_async_slot *p_slot)
+{
+	return p_slot->svc.set_off_d.resp_error_code;
+}
+
 /**
- * @brief Check the MHUv2 devices are ready and initialize callbacks for
- * the received and send data.
+ * @brief Queue heartbeat service request to SE.
+ *
+ * parameters,
+ * @done - completion callback and/or poll signal, copied by the call.
  *
  * returns,
- * 0       - success.
- * -ENODEV - if the MHUv2 devices are not ready.
+ * 0       - request queued, result is delivered through done.
+ * -EINVAL - no completion given.
+ * -ENOMEM - all request slots are in use.
  */
-static int se_service_mhuv2_nodes_init(void)
+int se_service_heartbeat_async(const struct se_service_async *done)
 {
-	send_dev = DEVICE_DT_GET_OR_NULL(DT_PHANDLE(DT_NODELABEL(se_service), mhuv2_send_node));
-	recv_dev = DEVICE_DT_GET_OR_NULL(DT_PHANDLE(DT_NODELABEL(se_service), mhuv2_recv_node));
+	struct se_service_async_slot *p_slot;
+	int err = async_slot_alloc(done, &p_slot);
 
-	if (!device_is_ready(recv_dev) || !device_is_ready(send_dev)) {
+	if (err) {
+		return err;
+	}
+
+	p_slot->svc.service_header.hdr_service_id = SERVICE_MAINTENANCE_HEARTBEAT_ID;
+	return async_slot_submit(p_slot, sizeof(p_slot->svc.service_header),
+				 async_heartbeat_complete);
+}
+
+/**
+ * @brief Queue random number service request to SE.
+ *
+ * parameters,
+ * @buffer - placeholder for random number, must stay valid until completion.
+ * @length - length of requested random number, up to MAX_RND_LENGTH.
+ * @done   - completion callback and/or poll signal, copied by the call.
+ *
+ * returns,
+ * 0       - request queued, result is delivered through done.
+ * -EINVAL - invalid argument.
+ * -ENOMEM - all request slots are in use.
+ */
+int se_service_get_rnd_num_async(uint8_t *buffer, uint16_t length,
+				 const struct se_service_async *done)
+{
+	struct se_service_async_slot *p_slot;
+	int err;
+
+	if (!buffer || length > MAX_RND_LENGTH) {
+		return -EINVAL;
+	}
+	err = async_slot_alloc(done, &p_slot);
+	if (err) {
+		return err;
+	}
+
+	p_slot->svc.get_rnd_svc_d.header.hdr_service_id = SERVICE_CRYPTOCELL_GET_RND;
+	p_slot->svc.get_rnd_svc_d.send_rnd_length = length;
+	p_slot->resp_buf = buffer;
+	p_slot->resp_len = length;
+	return async_slot_submit(p_slot, sizeof(p_slot->svc.get_rnd_svc_d), async_rnd_complete);
+}
+
+/**
+ * @brief Queue run profile update to SE.
+ *
+ * parameters,
+ * @pp   - run profile, copied by the call.
+ * @done - completion callback and/or poll signal, copied by the call.
+ *
+ * returns,
+ * 0       - request queued, result is delivered through done.
+ * -EINVAL - invalid argument.
+ * -ENOMEM - all request slots are in use.
+ */
+int se_service_set_run_cfg_async(const run_profile_t *pp, const struct se_service_async *done)
+{
+	struct se_service_async_slot *p_slot;
+	int err;
+
+	if (!pp) {
+		return -EINVAL;
+	}
+	err = async_slot_alloc(done, &p_slot);
+	if (err) {
+		return err;
+	}
+
+	set_run_cfg_fill(&p_slot->svc.set_run_d, pp);
+	return async_slot_submit(p_slot, sizeof(p_slot->svc.set_run_d), async_set_run_complete);
+}
+
+/**
+ * @brief Queue off profile update to SE.
+ *
+ * parameters,
+ * @wp   - off profile, copied by the call.
+ * @done - completion callback and/or poll signal, copied by the call.
+ *
+ * returns,
+ * 0       - request queued, result is delivered through done.
+ * -EINVAL - invalid argument.
+ * -ENOMEM - all request slots are in use.
+ */
+int se_service_set_off_cfg_async(const off_profile_t *wp, const struct se_service_async *done)
+{
+	struct se_service_async_slot *p_slot;
+	int err;
+
+	if (!wp) {
+		return -EINVAL;
+	}
+	err = async_slot_alloc(done, &p_slot);
+	if (err) {
+		return err;
+	}
+
+	set_off_cfg_fill(&p_slot->svc.set_off_d, wp);
+	return async_slot_submit(p_slot, sizeof(p_slot->svc.set_off_d), async_set_off_complete);
+}
+
+/**
+ * @brief Serve queued requests one at a time.
+ *
+ * The worker shares svc_mutex with the synchronous API, so SE sees one
+ * request at a time. Only the requesting thread of a synchronous call
+ * blocks on the SE, async callers continue once their request is queued.
+ */
+static void se_service_async_thread(void *p1, void *p2, void *p3)
+{
+	struct se_service_async_slot *p_slot;
+	int err;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_msgq_get(&async_msgq, &p_slot, K_FOREVER);
+
+		err = k_mutex_lock(&svc_mutex, K_MSEC(MUTEX_TIMEOUT));
+		if (err) {
+			LOG_ERR("Unable to lock mutex (error = %d)\n", err);
+		} else {
+			err = send_msg_to_se((uint32_t *)&p_slot->svc, p_slot->size,
+					     SERVICE_TIMEOUT);
+			if (!err) {
+				err = p_slot->complete(p_slot);
+			}
+			k_mutex_unlock(&svc_mutex);
+		}
+		if (err) {
+			LOG_ERR("service %d failed with %d\n",
+				p_slot->svc.service_header.hdr_service_id, err);
+		}
+
+		if (p_slot->done.cb) {
+			p_slot->done.cb(err, p_slot->done.user_data);
+		}
+#if defined(CONFIG_POLL)
+		if (p_slot->done.signal) {
+			k_poll_signal_raise(p_slot->done.signal, err);
+		}
+#endif
+		k_mem_slab_free(&async_slab, (void *)p_slot);
+	}
+}
+
+K_THREAD_DEFINE(se_service_async_tid, CONFIG_SE_SERVICE_ASYNC_STACK_SIZE,
+		se_service_async_thread, NULL, NULL, NULL,
+		CONFIG_SE_SERVICE_ASYNC_THREAD_PRIORITY, 0, 0);
+#endif /* CONFIG_SE_SERVICE_ASYNC */
+
+static int se_service_ipm_bind(const struct device *send, const struct device *recv)
+{
+	if (!device_is_ready(recv) || !device_is_ready(send)) {
 		printk("MHU devices not ready\n");
 		return -ENODEV;
 	}
 
+	if (recv_dev) {
+		ipm_set_enabled(recv_dev, false);
+	}
+
+	send_dev = send;
+	recv_dev = recv;
+
 	ipm_register_callback(recv_dev, callback_for_receive_msg, &se_service_recv_data);
 	ipm_register_callback(send_dev, callback_for_send_msg, NULL);
 
@@ -1293,4 +1684,59 @@ static int se_service_mhuv2_nodes_init(void)
 	return 0;
 }
 
+#if defined(CONFIG_SE_SERVICE_IPM_OVERRIDE)
+/**
+ * @brief Route SE service requests through another IPM device pair.
+ *
+ * Any IPM driver pair can stand in for the MHUv2 channels, e.g. an
+ * emulated SE on a target without Secure Enclave. Requests in flight
+ * are completed first.
+ *
+ * parameters,
+ * @send - IPM device used to send requests.
+ * @recv - IPM device delivering responses.
+ *
+ * returns,
+ * 0       - success.
+ * -ENODEV - if the devices are not ready.
+ * err     - unable to lock svc_mutex.
+ */
+int se_service_ipm_devices_set(const struct device *send, const struct device *recv)
+{
+	int err;
+
+	err = k_mutex_lock(&svc_mutex, K_MSEC(MUTEX_TIMEOUT));
+	if (err) {
+		LOG_ERR("Unable to lock mutex (error = %d)\n", err);
+		return err;
+	}
+
+	err = se_service_ipm_bind(send, recv);
+	k_sem_reset(&svc_send_sem);
+	k_sem_reset(&svc_recv_sem);
+	k_mutex_unlock(&svc_mutex);
+	return err;
+}
+#endif /* CONFIG_SE_SERVICE_IPM_OVERRIDE */
+
+/**
+ * @brief Check the MHUv2 devices are ready and initialize callbacks for
+ * the received and send data.
+ *
+ * returns,
+ * 0       - success, or no SE services node with CONFIG_SE_SERVICE_IPM_OVERRIDE.
+ * -ENODEV - if the MHUv2 devices are not ready.
+ */
+static int se_service_mhuv2_nodes_init(void)
+{
+#if defined(CONFIG_SE_SERVICE_IPM_OVERRIDE) && !DT_NODE_EXISTS(DT_NODELABEL(se_service))
+	/* Requests fail with -ENODEV until se_service_ipm_devices_set() */
+	return 0;
+#else
+	return se_service_ipm_bind(
+		DEVICE_DT_GET_OR_NULL(DT_PHANDLE(DT_NODELABEL(se_service), mhuv2_send_node)),
+		DEVICE_DT_GET_OR_NULL(DT_PHANDLE(DT_NODELABEL(se_service), mhuv2_recv_node)));
+#endif
+}
+
 SYS_INIT(se_service_mhuv2_nodes_init, PRE_KERNEL_1, CONFIG_SE_SERVICE_INIT_PRIORITY);
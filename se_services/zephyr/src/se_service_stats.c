@@ -0,0 +1,183 @@
+/* Copyright (C) 2024  Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "se_service_stats.h"
+
+/* Bucket 0 holds times below 2^SE_STATS_FIRST_BUCKET_LOG2 us */
+#define SE_STATS_FIRST_BUCKET_LOG2 7
+
+static struct k_spinlock se_stats_lock;
+static struct se_service_stats se_stats[CONFIG_SE_SERVICE_STATS_SIZE];
+static uint32_t se_stats_used;
+static uint32_t se_stats_untracked;
+static struct se_service_sync_stats se_sync_stats;
+
+/**
+ * @brief Histogram bucket of a round-trip time.
+ *
+ * returns,
+ * bucket index, times over the last bucket limit land in the last bucket.
+ */
+static uint32_t se_stats_bucket(uint32_t time_us)
+{
+	int bucket = (int)find_msb_set(time_us) - SE_STATS_FIRST_BUCKET_LOG2;
+
+	return CLAMP(bucket, 0, SE_STATS_LATENCY_BUCKETS - 1);
+}
+
+/**
+ * @brief Statistics entry of a service id, a new one is taken if needed.
+ *
+ * returns,
+ * entry, NULL when all CONFIG_SE_SERVICE_STATS_SIZE entries are taken.
+ */
+static struct se_service_stats *se_stats_entry(uint32_t service_id)
+{
+	for (uint32_t i = 0; i < se_stats_used; i++) {
+		if (se_stats[i].service_id == service_id) {
+			return &se_stats[i];
+		}
+	}
+	if (se_stats_used == ARRAY_SIZE(se_stats)) {
+		return NULL;
+	}
+	se_stats[se_stats_used].service_id = service_id;
+	return &se_stats[se_stats_used++];
+}
+
+void se_service_stats_record(uint32_t service_id, bool polled, uint32_t ack_us,
+			     uint32_t resp_us, int err)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_stats_lock);
+	struct se_service_stats *entry = se_stats_entry(service_id);
+
+	if (entry == NULL) {
+		se_stats_untracked++;
+		goto out;
+	}
+
+	entry->count++;
+	entry->polled += polled;
+	entry->failures += (err != 0);
+	if (ack_us) {
+		entry->ack_hist[se_stats_bucket(ack_us)]++;
+		entry->max_ack_us = MAX(entry->max_ack_us, ack_us);
+	}
+	if (resp_us) {
+		entry->resp_hist[se_stats_bucket(resp_us)]++;
+		entry->max_resp_us = MAX(entry->max_resp_us, resp_us);
+	}
+out:
+	k_spin_unlock(&se_stats_lock, key);
+}
+
+void se_service_stats_sync_record(uint32_t retries, int err)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_stats_lock);
+
+	se_sync_stats.calls++;
+	se_sync_stats.failures += (err != 0);
+	se_sync_stats.retries += retries;
+	se_sync_stats.max_retries = MAX(se_sync_stats.max_retries, retries);
+	k_spin_unlock(&se_stats_lock, key);
+}
+
+int se_service_stats_get(int index, struct se_service_stats *p_stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_stats_lock);
+	int ret = -ENOENT;
+
+	if (index >= 0 && (uint32_t)index < se_stats_used) {
+		*p_stats = se_stats[index];
+		ret = 0;
+	}
+	k_spin_unlock(&se_stats_lock, key);
+	return ret;
+}
+
+void se_service_stats_sync_get(struct se_service_sync_stats *p_stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_stats_lock);
+
+	*p_stats = se_sync_stats;
+	k_spin_unlock(&se_stats_lock, key);
+}
+
+void se_service_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&se_stats_lock);
+
+	memset(se_stats, 0, sizeof(se_stats));
+	memset(&se_sync_stats, 0, sizeof(se_sync_stats));
+	se_stats_used = 0;
+	se_stats_untracked = 0;
+	k_spin_unlock(&se_stats_lock, key);
+}
+
+#if defined(CONFIG_SHELL)
+static void se_stats_hist_print(const struct shell *sh, const char *name,
+				const uint32_t *hist, uint32_t max_us)
+{
+	shell_fprintf(sh, SHELL_NORMAL, "    %-4s max %7uus |", name, max_us);
+	for (int i = 0; i < SE_STATS_LATENCY_BUCKETS; i++) {
+		shell_fprintf(sh, SHELL_NORMAL, " %u", hist[i]);
+	}
+	shell_fprintf(sh, SHELL_NORMAL, "\n");
+}
+
+static int cmd_se_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct se_service_stats entry;
+	struct se_service_sync_stats sync;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(sh, "SE services (histogram: <%uus, then doubling)",
+		    1U << SE_STATS_FIRST_BUCKET_LOG2);
+	for (int i = 0; se_service_stats_get(i, &entry) == 0; i++) {
+		shell_print(sh, "  id %3u  total %u  polled %u  failed %u", entry.service_id,
+			    entry.count, entry.polled, entry.failures);
+		se_stats_hist_print(sh, "ack", entry.ack_hist, entry.max_ack_us);
+		se_stats_hist_print(sh, "resp", entry.resp_hist, entry.max_resp_us);
+	}
+	if (se_stats_untracked) {
+		shell_print(sh, "  %u transfers of other ids not tracked", se_stats_untracked);
+	}
+
+	se_service_stats_sync_get(&sync);
+	shell_print(sh, "se_service_sync: %u calls, %u failed, %u retries (max %u)",
+		    sync.calls, sync.failures, sync.retries, sync.max_retries);
+	return 0;
+}
+
+static int cmd_se_stats_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	se_service_stats_reset();
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_se_service_stats,
+			       SHELL_CMD(clear, NULL, "Clear SE service statistics",
+					 cmd_se_stats_clear),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_se_service,
+			       SHELL_CMD(stats, &sub_se_service_stats,
+					 "Show SE service round-trip statistics", cmd_se_stats),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(se_service, &sub_se_service, "Secure Enclave services", NULL);
+#endif /* CONFIG_SHELL */
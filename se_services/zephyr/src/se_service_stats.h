@@ -0,0 +1,58 @@
+/* Copyright (C) 2024  Alif Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef SE_SERVICES_ZEPHYR_SRC_SE_SERVICE_STATS_H_
+#define SE_SERVICES_ZEPHYR_SRC_SE_SERVICE_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Doubling latency buckets, first one covers times below 128us */
+#define SE_STATS_LATENCY_BUCKETS 12
+
+struct se_service_stats {
+	uint32_t service_id;
+	uint32_t count;
+	uint32_t polled;
+	uint32_t failures;
+	uint32_t max_ack_us;
+	uint32_t max_resp_us;
+	uint32_t ack_hist[SE_STATS_LATENCY_BUCKETS];
+	uint32_t resp_hist[SE_STATS_LATENCY_BUCKETS];
+};
+
+struct se_service_sync_stats {
+	uint32_t calls;
+	uint32_t failures;
+	uint32_t retries;
+	uint32_t max_retries;
+};
+
+/**
+ * @brief Record one SE service transfer.
+ *
+ * parameters,
+ * @service_id - service id of the request.
+ * @polled     - true when transfer was done in polling mode.
+ * @ack_us     - time until SE acknowledged the request, 0 if it did not.
+ * @resp_us    - time from acknowledge until the response, 0 if none.
+ * @err        - transfer result.
+ */
+void se_service_stats_record(uint32_t service_id, bool polled, uint32_t ack_us,
+			     uint32_t resp_us, int err);
+
+/**
+ * @brief Record one se_service_sync call.
+ *
+ * parameters,
+ * @retries - heartbeats that failed before SE answered.
+ * @err     - sync result.
+ */
+void se_service_stats_sync_record(uint32_t retries, int err);
+
+int se_service_stats_get(int index, struct se_service_stats *p_stats);
+void se_service_stats_sync_get(struct se_service_sync_stats *p_stats);
+void se_service_stats_reset(void);
+
+#endif /* SE_SERVICES_ZEPHYR_SRC_SE_SERVICE_STATS_H_ */